@@ -0,0 +1,84 @@
+/*
+  This program measures the cost of parsing data frames with
+  MyLD2410 (reads through the virtual Stream interface) and
+  with MyLD2410T<SerialT> (reads through the concrete type).
+
+  No sensor is needed: a replay stream serves a recorded
+  enhanced-mode data frame over and over again.
+
+  #define SERIAL_BAUD_RATE sets the serial monitor baud rate
+
+  Communication with the sensor is handled by the
+  "MyLD2410" library Copyright (c) Iavor Veltchev 2025
+*/
+#include "MyLD2410.h"
+
+// User defines
+#define SERIAL_BAUD_RATE 115200
+#define FRAMES 1000
+
+// A recorded enhanced-mode data frame
+const byte frame[] = {
+  0xF4, 0xF3, 0xF2, 0xF1, 0x23, 0x00, 0x01, 0xAA, 0x03, 0x1E, 0x00, 0x64, 0x07, 0x01, 0x64, 0x83,
+  0x00, 0x08, 0x08, 0x64, 0x64, 0x1F, 0x24, 0x22, 0x1E, 0x0A, 0x03, 0x06, 0x00, 0x00, 0x52, 0x64,
+  0x64, 0x4F, 0x4F, 0x47, 0x23, 0xAF, 0x01, 0x55, 0x00, 0xF8, 0xF7, 0xF6, 0xF5
+};
+
+class ReplayStream : public Stream {
+public:
+  unsigned long frames = 0;
+  int available() {
+    return (frames) ? 1 : 0;
+  }
+  int read() {
+    byte b = frame[pos++];
+    if (pos == sizeof(frame)) {
+      pos = 0;
+      frames--;
+    }
+    return b;
+  }
+  int peek() {
+    return frame[pos];
+  }
+  size_t write(uint8_t) {
+    return 1;
+  }
+private:
+  size_t pos = 0;
+};
+
+ReplayStream replay;
+MyLD2410 generic(replay);
+MyLD2410T<ReplayStream> direct(replay);
+
+unsigned long cycles() {
+#if defined(ESP32) || defined(ESP8266)
+  return ESP.getCycleCount();
+#else
+  return micros() * clockCyclesPerMicrosecond();
+#endif
+}
+
+template<class Sensor>
+unsigned long run(Sensor &sensor) {
+  replay.frames = FRAMES;
+  unsigned long t0 = cycles();
+  while (replay.frames) sensor.check();
+  return (cycles() - t0) / FRAMES;
+}
+
+void setup() {
+  Serial.begin(SERIAL_BAUD_RATE);
+  delay(1000);
+  Serial.print(sizeof(frame));
+  Serial.println(" bytes per frame, CPU cycles per frame:");
+}
+
+void loop() {
+  Serial.print("MyLD2410: ");
+  Serial.print(run(generic));
+  Serial.print("  MyLD2410T<ReplayStream>: ");
+  Serial.println(run(direct));
+  delay(2000);
+}
@@ -0,0 +1,66 @@
+/*
+  This program receives data frames from the HLK-LD2410
+  presence sensor without polling: the UART driver feeds
+  the received bytes to the library, and the loop() task
+  sleeps until a complete data frame has been decoded.
+  It works on ESP32 boards only.
+
+  #define SERIAL_BAUD_RATE sets the serial monitor baud rate
+
+  Communication with the sensor is handled by the
+  "MyLD2410" library Copyright (c) Iavor Veltchev 2025
+
+  Use only hardware UART at the default baud rate 256000,
+  or change the #define LD2410_BAUD_RATE to match your sensor.
+  Modify the RX_PIN and TX_PIN defines below to match your wiring.
+
+  Connection diagram:
+  ESP32 RX  -- TX LD2410
+  ESP32 TX  -- RX LD2410
+  ESP32 GND -- GND LD2410
+  Provide sufficient power to the sensor Vcc (200mA, 5-12V)
+*/
+#if !defined(ESP32)
+#error "This sketch only works on ESP32"
+#endif
+#define sensorSerial Serial1
+#define RX_PIN 16
+#define TX_PIN 17
+// Change the communication baud rate here, if previously configured
+// #define LD2410_BAUD_RATE 256000
+#include "MyLD2410.h"
+#include "LD2410Esp32.h"
+
+// User defines
+#define SERIAL_BAUD_RATE 115200
+
+MyLD2410 sensor(sensorSerial);
+LD2410Esp32 events(sensor, sensorSerial);
+
+void setup() {
+  Serial.begin(SERIAL_BAUD_RATE);
+  sensorSerial.begin(LD2410_BAUD_RATE, SERIAL_8N1, RX_PIN, TX_PIN);
+  delay(2000);
+  Serial.println(__FILE__);
+  if (!sensor.begin()) {
+    Serial.println("Failed to communicate with the sensor.");
+    while (true) {}
+  }
+  // notify the loop() task of every data frame
+  events.begin();
+}
+
+void loop() {
+  static byte status = 0xFF;
+  MyLD2410::SensorData data;
+  if (!events.wait(data, pdMS_TO_TICKS(1000))) {
+    Serial.println("No data from the sensor");
+    return;
+  }
+  if (data.status != status) {
+    status = data.status;
+    Serial.print(micros() - data.timestampUs);
+    Serial.print("us after the frame start, status: ");
+    Serial.println(status);
+  }
+}
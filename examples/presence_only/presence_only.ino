@@ -0,0 +1,59 @@
+/*
+  This program only reads the presence status of the
+  HLK-LD2410 presence sensor and prints it on change.
+  It is the smallest use of the library, e.g. on an
+  Arduino Nano/Uno with SoftwareSerial.
+
+  To strip everything this sketch does not need, uncomment
+  #define LD2410_MINIMAL in MyLD2410Config.h (in the library folder),
+  or pass -DLD2410_MINIMAL to the whole build.
+  A #define in the sketch itself does not reach the library.
+
+  #define SERIAL_BAUD_RATE sets the serial monitor baud rate
+
+  Communication with the sensor is handled by the
+  "MyLD2410" library Copyright (c) Iavor Veltchev 2025
+
+  Use only hardware UART at the default baud rate 256000,
+  or change the #define LD2410_BAUD_RATE to match your sensor.
+  For ESP32 or other boards that allow dynamic UART pins,
+  modify the RX_PIN and TX_PIN defines in "./board_select.h"
+
+  Connection diagram:
+  Arduino/ESP32 RX  -- TX LD2410
+  Arduino/ESP32 TX  -- RX LD2410
+  Arduino/ESP32 GND -- GND LD2410
+  Provide sufficient power to the sensor Vcc (200mA, 5-12V)
+*/
+#include "./board_select.h"
+// Change the communication baud rate here, if previously configured
+// #define LD2410_BAUD_RATE 256000
+#include "MyLD2410.h"
+
+// User defines
+#define SERIAL_BAUD_RATE 115200
+
+MyLD2410 sensor(sensorSerial);
+
+void setup() {
+  Serial.begin(SERIAL_BAUD_RATE);
+#if defined(ARDUINO_XIAO_ESP32C3) || defined(ARDUINO_XIAO_ESP32C6) || defined(ARDUINO_SAMD_NANO_33_IOT) || defined(ARDUINO_AVR_LEONARDO) || defined(ARDUINO_AVR_NANO) || defined(ARDUINO_AVR_UNO)
+  sensorSerial.begin(LD2410_BAUD_RATE);
+#else
+  sensorSerial.begin(LD2410_BAUD_RATE, SERIAL_8N1, RX_PIN, TX_PIN);
+#endif
+  delay(2000);
+  Serial.println(__FILE__);
+  if (!sensor.begin()) {
+    Serial.println("Failed to communicate with the sensor.");
+    while (true) {}
+  }
+}
+
+void loop() {
+  static bool present = false;
+  if ((sensor.check() == MyLD2410::Response::DATA) && (sensor.presenceDetected() != present)) {
+    present = !present;
+    Serial.println(sensor.statusString());
+  }
+}
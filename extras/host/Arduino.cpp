@@ -0,0 +1,80 @@
+#include "Arduino.h"
+#include <chrono>
+#include <ctype.h>
+#include <thread>
+
+namespace
+{
+  const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  template <typename Unit>
+  unsigned long elapsed()
+  {
+    return (unsigned long)std::chrono::duration_cast<Unit>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
+HostSerial Serial;
+
+unsigned long millis()
+{
+  return elapsed<std::chrono::milliseconds>();
+}
+
+unsigned long micros()
+{
+  return elapsed<std::chrono::microseconds>();
+}
+
+void delay(unsigned long ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() {}
+
+String::String(long value, int base)
+{
+  if (value < 0)
+    str = "-";
+  str += String((value < 0) ? 0UL - (unsigned long)value : (unsigned long)value, base).str;
+}
+
+String::String(unsigned long value, int base)
+{
+  char digits[33];
+  byte i = 0;
+  do
+  {
+    digits[i++] = "0123456789abcdef"[value % base];
+    value /= base;
+  } while (value);
+  while (i)
+    str += digits[--i];
+}
+
+void String::toUpperCase()
+{
+  for (size_t i = 0; i < str.size(); i++)
+    str[i] = char(toupper((unsigned char)str[i]));
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t n = 0;
+  while (size--)
+    n += write(*(buffer++));
+  return n;
+}
+
+size_t Print::print(double value, int digits)
+{
+  char s[32];
+  snprintf(s, sizeof(s), "%.*f", digits, value);
+  return print(s);
+}
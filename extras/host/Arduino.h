@@ -0,0 +1,135 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file Arduino.h
+ *
+ * The small part of the Arduino core that the library uses, for building it on a PC
+ * (see extras/host/README.md). Not used by Arduino builds.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+typedef uint8_t byte;
+
+#define DEC 10
+#define HEX 16
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+class String
+{
+public:
+  String(const char *s = "") : str(s) {}
+  String(unsigned char value, int base = DEC) : String((unsigned long)value, base) {}
+  String(int value, int base = DEC) : String(long(value), base) {}
+  String(unsigned int value, int base = DEC) : String((unsigned long)value, base) {}
+  String(long value, int base = DEC);
+  String(unsigned long value, int base = DEC);
+
+  unsigned int length() const { return str.size(); }
+  const char *c_str() const { return str.c_str(); }
+  char operator[](unsigned int i) const { return (i < str.size()) ? str[i] : 0; }
+  bool reserve(unsigned int size)
+  {
+    str.reserve(size);
+    return true;
+  }
+  void toUpperCase();
+
+  String &operator+=(const String &s)
+  {
+    str += s.str;
+    return *this;
+  }
+  String &operator+=(const char *s)
+  {
+    str += s;
+    return *this;
+  }
+  String &operator+=(char c)
+  {
+    str += c;
+    return *this;
+  }
+  friend String operator+(const String &a, const String &b)
+  {
+    String s(a);
+    return s += b;
+  }
+  friend String operator+(const char *a, const String &b)
+  {
+    String s(a);
+    return s += b;
+  }
+
+private:
+  std::string str;
+};
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t b) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+  virtual void flush() {}
+
+  size_t print(const char *s) { return write(s); }
+  size_t print(const String &s) { return write(s.c_str()); }
+  size_t print(char c) { return write(uint8_t(c)); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(int value, int base = DEC) { return print(long(value), base); }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(unsigned long value, int base = DEC) { return print(String(value, base)); }
+  size_t print(double value, int digits = 2);
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T &value) { return print(value) + println(); }
+  template <typename T>
+  size_t println(const T &value, int format) { return print(value, format) + println(); }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+/**
+ * @brief Serial prints to stdout and never receives anything
+ */
+class HostSerial : public Stream
+{
+public:
+  void begin(unsigned long) {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t b) override { return (fputc(b, stdout) == EOF) ? 0 : 1; }
+  using Print::write;
+};
+
+extern HostSerial Serial;
+
+#endif // HOST_ARDUINO_H
@@ -0,0 +1,171 @@
+/*
+  A mock UART event source for MyLD2410::feed(), to test the
+  event-driven reception of LD2410Esp32 on a PC.
+
+  The mock UART raises receive events the way the ESP32 driver does:
+  when its FIFO fills up, and when the line goes idle after a frame.
+  Each event is passed to feed() in chunks, like LD2410Esp32 does.
+  The stream holds basic and enhanced data frames, line noise and
+  frames with a broken tail. Every decoded frame is compared with
+  the frame that was sent.
+
+  Build and run it as described in extras/host/README.md.
+
+  Communication with the sensor is handled by the
+  "MyLD2410" library Copyright (c) Iavor Veltchev 2025
+*/
+#include "MyLD2410.h"
+#include <vector>
+
+#define FRAMES 10000
+#define FIFO_THRESHOLD 16 // bytes that raise a receive event before the line goes idle (low, to split frames)
+
+// The sensor side of the UART. feed() must never write to it.
+class MockUart : public Stream
+{
+public:
+  unsigned long written = 0;
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t) override
+  {
+    written++;
+    return 1;
+  }
+  using Print::write;
+};
+
+struct Sent
+{
+  byte status;
+  unsigned int distance;
+  bool enhanced;
+  byte gate3;
+};
+
+// a reproducible pseudo-random sequence
+unsigned long seed = 12345;
+unsigned long rnd(unsigned long range)
+{
+  seed = seed * 1103515245UL + 12345UL;
+  return ((seed >> 8) & 0xFFFFFF) % range;
+}
+
+void dataFrame(std::vector<byte> &line, const Sent &s, bool breakTail)
+{
+  std::vector<byte> p = {byte(s.enhanced ? 1 : 2), 0xAA, s.status,
+                         byte(s.distance), byte(s.distance >> 8), 60,
+                         byte(s.distance), byte(s.distance >> 8), 40,
+                         byte(s.distance), byte(s.distance >> 8)};
+  if (s.enhanced)
+  {
+    p.push_back(8);
+    p.push_back(8);
+    for (byte i = 0; i < 9; i++)
+      p.push_back((i == 3) ? s.gate3 : byte(10 + i));
+    for (byte i = 0; i < 9; i++)
+      p.push_back(byte(20 + i));
+    p.push_back(0x80);
+    p.push_back(0);
+  }
+  p.push_back(0x55);
+  p.push_back(0);
+  line.insert(line.end(), LD2410Parser::headData, LD2410Parser::headData + 4);
+  line.push_back(byte(p.size()));
+  line.push_back(0);
+  line.insert(line.end(), p.begin(), p.end());
+  line.insert(line.end(), LD2410Parser::tailData, LD2410Parser::tailData + 4);
+  if (breakTail)
+    line.back() ^= 0xFF;
+}
+
+MockUart uart;
+MyLD2410 sensor(uart);
+std::vector<Sent> sent;
+unsigned long decoded = 0;
+unsigned long mismatches = 0;
+
+void onData(const MyLD2410::SensorData &data, void *)
+{
+  if (decoded >= sent.size())
+  {
+    mismatches++;
+    return;
+  }
+  const Sent &s = sent[decoded++];
+  bool enhanced = data.mTargetSignals.N > 0;
+  if ((data.status != s.status) || (data.distance != s.distance) || (enhanced != s.enhanced) ||
+      (enhanced && (data.mTargetSignals.values[3] != s.gate3)))
+    mismatches++;
+}
+
+// LD2410Esp32::receive(): read the event in chunks of at most LD2410_BUFFER_SIZE bytes
+bool receiveEvent(const byte *event, size_t size)
+{
+  bool data = false;
+  for (size_t i = 0; i < size; i += LD2410_BUFFER_SIZE)
+  {
+    size_t n = (size - i < LD2410_BUFFER_SIZE) ? size - i : LD2410_BUFFER_SIZE;
+    if (sensor.feed(event + i, n) == MyLD2410::DATA)
+      data = true;
+  }
+  return data;
+}
+
+int main()
+{
+  sensor.onData(onData);
+  sensor.adaptiveMode(true); // must not send commands from feed()
+  unsigned long events = 0;
+  unsigned long notifications = 0;
+  unsigned long broken = 0;
+  unsigned long late = 0;
+  std::vector<byte> fifo;
+  for (unsigned long f = 0; f < FRAMES; f++)
+  {
+    std::vector<byte> line;
+    if (rnd(20) == 0)
+    { // line noise before the frame
+      for (unsigned long i = rnd(12); i; i--)
+        line.push_back(byte(rnd(256)));
+    }
+    Sent s = {byte(rnd(4)), unsigned(rnd(600)), rnd(2) == 0, byte(rnd(101))};
+    bool breakTail = rnd(50) == 0;
+    dataFrame(line, s, breakTail);
+    if (breakTail)
+      broken++;
+    else
+      sent.push_back(s);
+    unsigned long before = decoded;
+    // the FIFO raises an event every time it reaches the threshold
+    for (byte b : line)
+    {
+      fifo.push_back(b);
+      if (fifo.size() == FIFO_THRESHOLD)
+      {
+        events++;
+        if (receiveEvent(fifo.data(), fifo.size()))
+          notifications++;
+        fifo.clear();
+      }
+    }
+    // the line goes idle after the frame: the receive timeout raises an event
+    if (!fifo.empty())
+    {
+      events++;
+      if (receiveEvent(fifo.data(), fifo.size()))
+        notifications++;
+      fifo.clear();
+    }
+    if (!breakTail && (decoded != before + 1))
+      late++; // the frame was not delivered by the event that completed it
+  }
+  printf("frames sent: %lu (+%lu with a broken tail)\n", (unsigned long)sent.size(), broken);
+  printf("frames decoded: %lu, mismatches: %lu, delivered late: %lu\n", decoded, mismatches, late);
+  printf("receive events: %lu, application notifications: %lu\n", events, notifications);
+  printf("bytes written to the sensor by feed(): %lu\n", uart.written);
+  bool ok = (decoded == sent.size()) && !mismatches && !late && !uart.written;
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
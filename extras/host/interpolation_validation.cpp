@@ -0,0 +1,98 @@
+/*
+  Validates LD2410Interpolation against emulated target trajectories
+  with a known ground truth.
+
+  The emulator walks a target back and forth through the range at
+  walking speed, 10 frames per second. For every frame it produces the
+  nine gate energies of a radar return: a Gaussian profile around the
+  true position (0.6 gate wide), a random peak height and additive
+  noise, quantised to 0..100 like the sensor does. The refined distance
+  and the gate centre of the strongest gate are both compared with the
+  true distance.
+
+  Build and run it as described in extras/host/README.md.
+*/
+#include "LD2410Interpolation.h"
+#include <math.h>
+#include <stdio.h>
+
+#define SECONDS 600
+#define FPS 10
+
+// a reproducible pseudo-random sequence
+unsigned long seed = 2025;
+double uniform()
+{
+  seed = seed * 1103515245UL + 12345UL;
+  return double((seed >> 8) & 0xFFFFFF) / double(0x1000000);
+}
+
+struct Errors
+{
+  double sum = 0;
+  double max = 0;
+  unsigned long n = 0;
+  unsigned long within = 0; // errors below a quarter gate
+
+  void add(double error, double gateWidth)
+  {
+    error = fabs(error);
+    sum += error;
+    if (error > max)
+      max = error;
+    if (error < gateWidth / 4)
+      within++;
+    n++;
+  }
+};
+
+bool run(byte gateWidth, double noise)
+{
+  Errors centre, refined;
+  double first = 0.5 * gateWidth; // keep the peak inside the range, where both neighbours exist
+  double last = 8.5 * gateWidth;
+  double x = first;
+  double speed = 100.0 / FPS; // 1 m/s [cm per frame]
+  for (unsigned long f = 0; f < SECONDS * FPS; f++)
+  {
+    // walk back and forth, changing speed now and then
+    if ((x + speed > last) || (x + speed < first))
+      speed = -speed;
+    if (uniform() < 0.02)
+      speed = ((speed > 0) ? 1 : -1) * (30 + 120 * uniform()) / FPS;
+    x += speed;
+
+    LD2410Parser::ValuesArray signals;
+    signals.setN(8);
+    double height = 40 + 60 * uniform();
+    for (byte g = 0; g < 9; g++)
+    {
+      double d = ((g + 0.5) * gateWidth - x) / (0.6 * gateWidth);
+      double e = height * exp(-d * d / 2) + noise * (uniform() - 0.5) * 2;
+      signals.values[g] = byte((e < 0) ? 0 : (e > 100) ? 100 : e + 0.5);
+    }
+    LD2410Interpolation::Estimate estimate;
+    if (!LD2410Interpolation::refine(signals, gateWidth, estimate))
+      return false;
+    centre.add((estimate.gate + 0.5) * gateWidth - x, gateWidth);
+    refined.add(double(estimate.distance) - x, gateWidth);
+  }
+  printf("%3ucm gates, noise +-%2.0f: mean error %5.1fcm -> %5.1fcm (%.2f -> %.2f gate), max %5.1fcm -> %5.1fcm, "
+         "within 1/4 gate %3lu%% -> %3lu%%\n",
+         gateWidth, noise, centre.sum / centre.n, refined.sum / refined.n,
+         centre.sum / centre.n / gateWidth, refined.sum / refined.n / gateWidth,
+         centre.max, refined.max, 100 * centre.within / centre.n, 100 * refined.within / refined.n);
+  return refined.sum < centre.sum;
+}
+
+int main()
+{
+  bool ok = true;
+  const byte widths[2] = {75, 20};
+  const double noises[3] = {0, 3, 8};
+  for (byte w = 0; w < 2; w++)
+    for (byte i = 0; i < 3; i++)
+      ok = run(widths[w], noises[i]) && ok;
+  printf("%s\n", ok ? "PASS" : "FAIL");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+/*
+  Compares the throughput of LD2410Serializer with a naive encoder
+  that builds the same JSON by String concatenation, as sketches
+  usually do before publishing getSensorData().
+
+  Both encoders serialize the same enhanced-mode frame; the output
+  is checked to be identical first. The host String (extras/host)
+  allocates like the Arduino String does, so the relative cost is
+  representative, the absolute times are not.
+
+  Build and run it as described in extras/host/README.md (use -O2).
+*/
+#include "LD2410Serializer.h"
+#include <chrono>
+
+#define RECORDS 200000UL
+
+String values(const MyLD2410::ValuesArray &array)
+{
+  String s = "[";
+  for (byte i = 0; i <= array.N; i++)
+  {
+    if (i)
+      s += ",";
+    s += String(array.values[i]);
+  }
+  return s + "]";
+}
+
+String naiveJson(const MyLD2410::SensorData &data)
+{
+  String s = "{\"status\":" + String(data.status);
+  s += ",\"timestamp\":" + String(data.timestamp);
+  s += ",\"distance\":" + String(data.distance);
+  s += ",\"moving\":{\"distance\":" + String(data.mTargetDistance) + ",\"energy\":" + String(data.mTargetSignal) + "}";
+  s += ",\"stationary\":{\"distance\":" + String(data.sTargetDistance) + ",\"energy\":" + String(data.sTargetSignal) + "}";
+  if (data.mTargetSignals.N)
+  {
+    s += ",\"movingSignals\":" + values(data.mTargetSignals);
+    s += ",\"stationarySignals\":" + values(data.sTargetSignals);
+    s += ",\"light\":" + String(data.lightLevel);
+    s += ",\"out\":" + String(data.outLevel);
+  }
+  return s + "}";
+}
+
+// discards the output, to time the serializer alone
+class NullPrint : public Print
+{
+public:
+  size_t write(uint8_t) override { return 1; }
+  size_t write(const uint8_t *, size_t size) override { return size; }
+};
+
+template <typename Encode>
+double nsPerRecord(Encode encode, unsigned long &checksum)
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (unsigned long i = 0; i < RECORDS; i++)
+    checksum += encode(i);
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  return double(elapsed.count()) / RECORDS;
+}
+
+int main()
+{
+  MyLD2410::SensorData data;
+  data.status = 3;
+  data.timestamp = 1234567;
+  data.mTargetDistance = 131;
+  data.mTargetSignal = 50;
+  data.sTargetDistance = 100;
+  data.sTargetSignal = 60;
+  data.distance = 131;
+  data.mTargetSignals.setN(8);
+  data.sTargetSignals.setN(8);
+  for (byte i = 0; i < 9; i++)
+  {
+    data.mTargetSignals.values[i] = byte(10 + 7 * i);
+    data.sTargetSignals.values[i] = byte(5 + 3 * i);
+  }
+  data.lightLevel = 77;
+  data.outLevel = 1;
+
+  byte buffer[LD2410Serializer::MAX_DATA_SIZE + 1];
+  LD2410Serializer json(buffer, sizeof(buffer));
+  NullPrint null;
+  LD2410Serializer print(null);
+  size_t size = json.write(data);
+  String naive = naiveJson(data);
+  if ((size != naive.length()) || strcmp((const char *)buffer, naive.c_str()))
+  {
+    printf("FAIL: the outputs differ\n%s\n%s\n", (const char *)buffer, naive.c_str());
+    return 1;
+  }
+  unsigned long checksum = 0;
+  double serializer = nsPerRecord([&](unsigned long i)
+                                  { data.timestamp = i; return json.write(data); },
+                                  checksum);
+  double printed = nsPerRecord([&](unsigned long i)
+                               { data.timestamp = i; return print.write(data); },
+                               checksum);
+  double string = nsPerRecord([&](unsigned long i)
+                              { data.timestamp = i; return size_t(naiveJson(data).length()); },
+                              checksum);
+  printf("%zu-byte JSON record, %lu records (checksum %lu)\n", size, RECORDS, checksum);
+  printf("LD2410Serializer, buffer: %7.1f ns/record\n", serializer);
+  printf("LD2410Serializer, Print:  %7.1f ns/record\n", printed);
+  printf("String concatenation:     %7.1f ns/record (%.1fx)\n", string, string / serializer);
+  return 0;
+}
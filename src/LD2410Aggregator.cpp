@@ -0,0 +1,135 @@
+#include "LD2410Aggregator.h"
+
+LD2410Aggregator::LD2410Aggregator(unsigned long window, SummaryCallback callback, void *context)
+    : window(window), callback(callback), context(context)
+{
+  clear();
+  summary = Summary();
+}
+
+void LD2410Aggregator::setWindow(unsigned long window)
+{
+  this->window = window;
+}
+
+void LD2410Aggregator::onSummary(SummaryCallback callback, void *context)
+{
+  this->callback = callback;
+  this->context = context;
+}
+
+void LD2410Aggregator::clear()
+{
+  frames = lost = observed = present = moving = stationary = presentFrames = 0;
+  distanceSum = minDistance = maxDistance = 0;
+  enhanced = 0;
+  for (byte g = 0; g < 9; g++)
+  {
+    mSum[g] = sSum[g] = 0;
+    mMax[g] = sMax[g] = 0;
+  }
+}
+
+void LD2410Aggregator::hold(unsigned long duration)
+{
+  observed += duration;
+  if ((status >= 1) && (status <= 3))
+  {
+    present += duration;
+    if (status & 1)
+      moving += duration;
+    if (status & 2)
+      stationary += duration;
+  }
+}
+
+unsigned int LD2410Aggregator::perMille(unsigned long part, unsigned long whole)
+{
+  while (whole > 0x400000UL) // part * 1000 must not overflow
+  {
+    part >>= 1;
+    whole >>= 1;
+  }
+  return whole ? (part * 1000 + whole / 2) / whole : 0;
+}
+
+bool LD2410Aggregator::update(const LD2410Parser::SensorData &data, unsigned long suppressedFrames)
+{
+  unsigned long missed = data.missedFrames + suppressedFrames;
+  bool continued = frames;
+  if (continued)
+  { // the previous status held until this frame; of a hole, only the first frame interval counts
+    unsigned long interval = data.timestamp - end;
+    hold(missed ? interval / (missed + 1) : interval);
+    lost += missed;
+    end = data.timestamp;
+  }
+  bool finished = frames && (data.timestamp - start >= window) && flush();
+  if (!frames)
+  {
+    start = end = data.timestamp;
+    if (!continued)
+      lost += missed;
+  }
+  frames++;
+  status = data.status;
+  if ((data.status >= 1) && (data.status <= 3))
+  {
+    if (!presentFrames || (data.distance < minDistance))
+      minDistance = data.distance;
+    if (data.distance > maxDistance)
+      maxDistance = data.distance;
+    distanceSum += data.distance;
+    presentFrames++;
+  }
+  if (data.mTargetSignals.N)
+  {
+    enhanced++;
+    for (byte g = 0; g < 9; g++)
+    {
+      byte m = (g <= data.mTargetSignals.N) ? data.mTargetSignals.values[g] : 0;
+      byte s = (g <= data.sTargetSignals.N) ? data.sTargetSignals.values[g] : 0;
+      mSum[g] += m;
+      sSum[g] += s;
+      if (m > mMax[g])
+        mMax[g] = m;
+      if (s > sMax[g])
+        sMax[g] = s;
+    }
+  }
+  return finished;
+}
+
+bool LD2410Aggregator::flush()
+{
+  if (!frames)
+    return false;
+  summary.start = start;
+  summary.end = end;
+  summary.frames = frames;
+  summary.lostFrames = lost;
+  summary.observed = observed;
+  summary.present = perMille(present, observed);
+  summary.moving = perMille(moving, observed);
+  summary.stationary = perMille(stationary, observed);
+  summary.minDistance = minDistance;
+  summary.maxDistance = maxDistance;
+  summary.meanDistance = presentFrames ? (distanceSum + presentFrames / 2) / presentFrames : 0;
+  summary.enhancedFrames = enhanced;
+  for (byte g = 0; g < 9; g++)
+  {
+    summary.movingMax[g] = mMax[g];
+    summary.stationaryMax[g] = sMax[g];
+    summary.movingMean[g] = enhanced ? (mSum[g] + enhanced / 2) / enhanced : 0;
+    summary.stationaryMean[g] = enhanced ? (sSum[g] + enhanced / 2) / enhanced : 0;
+  }
+  clear();
+  if (callback)
+    callback(summary, context);
+  return true;
+}
+
+const LD2410Aggregator::Summary &LD2410Aggregator::last() const
+{
+  return summary;
+}
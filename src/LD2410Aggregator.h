@@ -0,0 +1,130 @@
+#ifndef LD2410_AGGREGATOR_H
+#define LD2410_AGGREGATOR_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Aggregator.h
+ */
+
+#include "LD2410Parser.h"
+
+/**
+ * @brief Reduces the frame stream to one occupancy summary per time window.
+ *
+ * Feed it every decoded frame; O(1) work and fixed memory per frame. When a frame falls past
+ * the end of the current window, the finished summary is passed to the callback and a new
+ * window starts with that frame.
+ *
+ * The presence fractions are weighted by time: the status of a frame holds until the next frame.
+ * Where frames were lost in between (transmission errors, or a config session), only one frame
+ * interval is counted, and the rest of the time is left out as unobserved.
+ */
+class LD2410Aggregator
+{
+public:
+  struct Summary
+  {
+    unsigned long start;          // timestamp of the first frame [ms]
+    unsigned long end;            // timestamp of the frame that closed the window, or of the last frame on flush() [ms]
+    unsigned long frames;         // frames in the window
+    unsigned long lostFrames;     // frames estimated lost: SensorData::missedFrames and the frames suppressed in config mode
+    unsigned long observed;       // time covered by received frames [ms]
+    unsigned int present;         // fraction of the observed time with presence [1/1000]
+    unsigned int moving;          // fraction of the observed time with a moving target [1/1000]
+    unsigned int stationary;      // fraction of the observed time with a stationary target [1/1000]
+    unsigned long minDistance;    // detection distance over the frames with presence [cm]
+    unsigned long meanDistance;   // (all 0 if there was no presence)
+    unsigned long maxDistance;    //
+    unsigned long enhancedFrames; // frames that carried gate energies
+    byte movingMax[9];            // per-gate energies over the enhanced frames
+    byte movingMean[9];           //
+    byte stationaryMax[9];        //
+    byte stationaryMean[9];       //
+  };
+  typedef void (*SummaryCallback)(const Summary &summary, void *context);
+
+  /**
+   * @brief Construct a new LD2410Aggregator object
+   *
+   * @param window - the window length [ms]
+   * @param callback - receives every finished window
+   * @param context - passed to the callback
+   */
+  LD2410Aggregator(unsigned long window = 60000, SummaryCallback callback = nullptr, void *context = nullptr);
+
+  /**
+   * @brief Change the window length; takes effect with the next window
+   */
+  void setWindow(unsigned long window);
+
+  /**
+   * @brief Set the callback that receives every finished window
+   */
+  void onSummary(SummaryCallback callback, void *context = nullptr);
+
+  /**
+   * @brief Feed a decoded frame
+   *
+   * @param data - the frame
+   * @param suppressedFrames - frames the sensor did not send right before this one because of config mode
+   * (see update(sensor))
+   * @return true if this frame finished a window
+   */
+  bool update(const LD2410Parser::SensorData &data, unsigned long suppressedFrames = 0);
+
+  /**
+   * @brief Feed the latest frame of a MyLD2410, including the frames it did not send during a config session
+   * that ended with this frame (MyLD2410::getLastConfigGap())
+   *
+   * @return true if this frame finished a window
+   */
+  template <class Sensor>
+  bool update(Sensor &sensor)
+  {
+    const LD2410Parser::SensorData &data = sensor.getSensorData();
+    unsigned long suppressed = (sensor.getLastConfigGap().end == data.timestamp) ? sensor.getLastConfigGap().frames : 0;
+    return update(data, suppressed);
+  }
+
+  /**
+   * @brief Finish the current window now (e.g. before sleeping)
+   *
+   * @return true if the window contained any frames
+   */
+  bool flush();
+
+  /**
+   * @brief Get the latest finished window
+   */
+  const Summary &last() const;
+
+private:
+  unsigned long window;
+  SummaryCallback callback;
+  void *context;
+  Summary summary;
+  // running sums of the current window
+  unsigned long frames = 0;
+  unsigned long lost = 0;
+  unsigned long observed = 0;
+  unsigned long present = 0, moving = 0, stationary = 0; // [ms]
+  unsigned long presentFrames = 0;
+  unsigned long distanceSum = 0, minDistance = 0, maxDistance = 0;
+  byte status = 0; // of the previous frame
+  unsigned long enhanced = 0;
+  unsigned long start = 0, end = 0;
+  unsigned long mSum[9], sSum[9];
+  byte mMax[9], sMax[9];
+  void clear();
+  void hold(unsigned long duration);
+  static unsigned int perMille(unsigned long part, unsigned long whole);
+};
+
+#endif // LD2410_AGGREGATOR_H
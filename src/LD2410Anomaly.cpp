@@ -0,0 +1,105 @@
+#include "LD2410Anomaly.h"
+
+namespace
+{
+  // a deviation smaller than this is never anomalous, even with a near-zero variance
+  const long minDeviation = 5 * 256;
+  // the baseline is trusted after a few EWMA time constants of empty frames
+  const unsigned long warmupConstants = 2;
+}
+
+LD2410Anomaly::LD2410Anomaly(byte persistence, byte k, byte shift)
+    : persistence(persistence), k(k), shift(shift)
+{
+  reset();
+}
+
+void LD2410Anomaly::setThresholds(const LD2410Parser::ValuesArray &moving, const LD2410Parser::ValuesArray &stationary)
+{
+  for (byte g = 0; g < 9; g++)
+  {
+    thresholds[1][g] = (g <= moving.N) ? moving.values[g] : 0xFF;
+    thresholds[0][g] = (g <= stationary.N) ? stationary.values[g] : 0xFF;
+  }
+  hasThresholds = true;
+}
+
+bool LD2410Anomaly::updateGate(Gate &gate, byte energy, byte threshold, bool empty)
+{
+  if (!empty)
+    return false;
+  if (!learned)
+  { // start from the first empty frame instead of zero
+    gate.baseline.seed(energy);
+    return false;
+  }
+  long d = gate.baseline.deviation(energy);
+  bool anomalous = hasThresholds && (energy >= threshold);
+  if ((learned >= (warmupConstants << shift)) && (d > minDeviation))
+    anomalous = anomalous || gate.baseline.exceeds(d, k);
+  if (anomalous)
+  { // a persistent source is absorbed into the baseline only 16 times slower
+    gate.baseline.follow(d, shift + 4);
+    if (gate.score < 0xFF)
+      gate.score++;
+  }
+  else
+  {
+    gate.baseline.learn(d, shift);
+    if (gate.score)
+      gate.score--;
+  }
+  return anomalous;
+}
+
+bool LD2410Anomaly::update(const LD2410Parser::SensorData &data, bool empty)
+{
+  if (!data.mTargetSignals.N)
+    return false;
+  const LD2410Parser::ValuesArray *signals[2] = {&data.sTargetSignals, &data.mTargetSignals};
+  unsigned int before[2] = {masks[0], masks[1]};
+  for (byte t = 0; t < 2; t++)
+    for (byte g = 0; g <= signals[t]->N; g++)
+    {
+      Gate &gate = gates[t][g];
+      updateGate(gate, signals[t]->values[g], thresholds[t][g], empty);
+      if (gate.score >= persistence)
+        masks[t] |= (1U << g);
+      else if (!gate.score)
+        masks[t] &= ~(1U << g);
+    }
+  if (empty)
+    learned++;
+  return (masks[0] != before[0]) || (masks[1] != before[1]);
+}
+
+unsigned int LD2410Anomaly::suspectMask(bool moving) const
+{
+  return masks[moving ? 1 : 0];
+}
+
+long LD2410Anomaly::mean(byte gate, bool moving) const
+{
+  return gates[moving ? 1 : 0][(gate < 9) ? gate : 8].baseline.mean();
+}
+
+unsigned long LD2410Anomaly::variance(byte gate, bool moving) const
+{
+  return gates[moving ? 1 : 0][(gate < 9) ? gate : 8].baseline.variance();
+}
+
+void LD2410Anomaly::reset()
+{
+  for (byte t = 0; t < 2; t++)
+  {
+    masks[t] = 0;
+    for (byte g = 0; g < 9; g++)
+    {
+      gates[t][g].baseline.reset();
+      gates[t][g].score = 0;
+      thresholds[t][g] = 0xFF;
+    }
+  }
+  hasThresholds = false;
+  learned = 0;
+}
@@ -0,0 +1,98 @@
+#ifndef LD2410_ANOMALY_H
+#define LD2410_ANOMALY_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Anomaly.h
+ */
+
+#include "LD2410Baseline.h"
+
+/**
+ * @brief Finds gates with persistent interference (fans, vents, other radars) in an empty room.
+ *
+ * Keeps an EWMA mean and variance of every gate energy (moving and stationary), learned from
+ * enhanced-mode frames while the room is known to be empty. The mean starts at the first empty frame,
+ * and detection starts after two time constants (2^(shift+1) empty frames). While the room is empty, a gate
+ * energy that lies far above its baseline, or above the gate threshold (if thresholds are set),
+ * counts as anomalous. A gate becomes suspect after `persistence` more anomalous than normal
+ * frames, and stops being suspect once the count has decayed back to zero. Anomalous energies
+ * enter the baseline 16 times slower, so a permanent source is eventually accepted as normal.
+ * Integer arithmetic and constant memory (~150 bytes).
+ */
+class LD2410Anomaly
+{
+public:
+  /**
+   * @brief Construct a new LD2410Anomaly object
+   *
+   * @param persistence - anomalous frames before a gate becomes suspect (10 frames/s)
+   * @param k - the anomaly limit in standard deviations above the baseline mean
+   * @param shift - the EWMA weight is 1/2^shift per frame (8: a time constant of ~25s at 10 frames/s)
+   */
+  LD2410Anomaly(byte persistence = 50, byte k = 3, byte shift = 8);
+
+  /**
+   * @brief Also count energies at or above the gate thresholds as anomalous
+   *
+   * @param moving - sensor.getMovingThresholds()
+   * @param stationary - sensor.getStationaryThresholds()
+   */
+  void setThresholds(const LD2410Parser::ValuesArray &moving, const LD2410Parser::ValuesArray &stationary);
+
+  /**
+   * @brief Feed a decoded frame; basic-mode frames are ignored
+   *
+   * @param data - the frame
+   * @param empty - true if the room is known to be empty (e.g. a door contact, a schedule)
+   * @return true if the suspect masks changed
+   */
+  bool update(const LD2410Parser::SensorData &data, bool empty);
+
+  /**
+   * @brief Get the suspect gates as a bit mask (bit g = gate g)
+   *
+   * @param moving - true for the moving energies, false for the stationary energies
+   */
+  unsigned int suspectMask(bool moving = false) const;
+
+  /**
+   * @brief Get the baseline mean energy of a gate [1/256]
+   */
+  long mean(byte gate, bool moving = false) const;
+
+  /**
+   * @brief Get the baseline variance of a gate [1/16]
+   */
+  unsigned long variance(byte gate, bool moving = false) const;
+
+  /**
+   * @brief Forget the baselines and the suspect gates
+   */
+  void reset();
+
+private:
+  struct Gate
+  {
+    LD2410Baseline baseline;
+    byte score; // anomalous minus normal frames, saturating
+  };
+  Gate gates[2][9]; // [0] stationary, [1] moving
+  unsigned int masks[2];
+  byte thresholds[2][9];
+  bool hasThresholds = false;
+  unsigned long learned = 0;
+  byte persistence;
+  byte k;
+  byte shift;
+  bool updateGate(Gate &gate, byte energy, byte threshold, bool empty);
+};
+
+#endif // LD2410_ANOMALY_H
@@ -0,0 +1,69 @@
+#include "LD2410Baseline.h"
+
+namespace
+{
+  unsigned long isqrt(unsigned long x)
+  {
+    unsigned long r = 0;
+    unsigned long bit = 1UL << 30;
+    while (bit > x)
+      bit >>= 2;
+    while (bit)
+    {
+      if (x >= r + bit)
+      {
+        x -= r + bit;
+        r = (r >> 1) + bit;
+      }
+      else
+        r >>= 1;
+      bit >>= 2;
+    }
+    return r;
+  }
+
+  // (d/64)^2 is [1/16], as is the variance
+  unsigned long square(long d)
+  {
+    return (unsigned long)((d >> 6) * (d >> 6));
+  }
+}
+
+void LD2410Baseline::seed(byte energy)
+{
+  m = long(energy) * 256;
+  v = 0;
+}
+
+long LD2410Baseline::deviation(byte energy) const
+{
+  return long(energy) * 256 - m;
+}
+
+void LD2410Baseline::learn(long d, byte shift)
+{
+  m += d >> shift;
+  v = v + ((long(square(d)) - long(v)) >> shift);
+}
+
+void LD2410Baseline::follow(long d, byte shift)
+{
+  m += d >> shift;
+}
+
+bool LD2410Baseline::exceeds(long d, byte k) const
+{
+  return (d > 0) && (square(d) > (unsigned long)(k * k) * v);
+}
+
+unsigned long LD2410Baseline::spread(byte k) const
+{
+  // the standard deviation is sqrt(variance)/4
+  return (k * isqrt(v) + 2) / 4;
+}
+
+void LD2410Baseline::reset()
+{
+  m = 0;
+  v = 0;
+}
@@ -0,0 +1,83 @@
+#ifndef LD2410_BASELINE_H
+#define LD2410_BASELINE_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Baseline.h
+ */
+
+#include "LD2410Parser.h"
+
+/**
+ * @brief The EWMA baseline (mean and variance) of one gate energy.
+ *
+ * Shared by LD2410Anomaly and LD2410Drift. The mean is kept in [1/256] and the variance
+ * in [1/16], so both fit integer arithmetic on AVR. The weight of a new sample is 1/2^shift.
+ */
+class LD2410Baseline
+{
+public:
+  /**
+   * @brief Start the baseline from a first sample, instead of ramping up from zero
+   */
+  void seed(byte energy);
+
+  /**
+   * @brief Get the deviation of a sample from the mean [1/256]
+   */
+  long deviation(byte energy) const;
+
+  /**
+   * @brief Learn a sample: update the mean and the variance
+   *
+   * @param d - the deviation of the sample, from deviation()
+   * @param shift - the EWMA weight is 1/2^shift
+   */
+  void learn(long d, byte shift);
+
+  /**
+   * @brief Follow a sample with the mean only, leaving the variance unchanged
+   *
+   * @param d - the deviation of the sample, from deviation()
+   * @param shift - the EWMA weight is 1/2^shift
+   */
+  void follow(long d, byte shift);
+
+  /**
+   * @brief Check whether a deviation is larger than k standard deviations
+   */
+  bool exceeds(long d, byte k) const;
+
+  /**
+   * @brief Get k standard deviations, rounded to whole energy units
+   */
+  unsigned long spread(byte k) const;
+
+  /**
+   * @brief Get the mean [1/256]
+   */
+  long mean() const { return m; }
+
+  /**
+   * @brief Get the variance [1/16]
+   */
+  unsigned long variance() const { return v; }
+
+  /**
+   * @brief Forget the baseline
+   */
+  void reset();
+
+private:
+  long m = 0;          // [1/256]
+  unsigned long v = 0; // [1/16]
+};
+
+#endif // LD2410_BASELINE_H
@@ -0,0 +1,124 @@
+#include "LD2410Candidates.h"
+
+LD2410Candidates::LD2410Candidates(byte minSeparation, byte maxStep) : separation(minSeparation), step(maxStep) {}
+
+byte LD2410Candidates::update(const LD2410Parser::SensorData &data,
+                              const LD2410Parser::ValuesArray &movingThresholds,
+                              const LD2410Parser::ValuesArray &stationaryThresholds,
+                              byte gateWidth)
+{
+  for (byte i = 0; i < count; i++)
+    previous[i] = list[i];
+  previousCount = count;
+  count = 0;
+  if (!data.mTargetSignals.N)
+    return 0;
+  findPeaks(data.mTargetSignals, movingThresholds, true, gateWidth);
+  findPeaks(data.sTargetSignals, stationaryThresholds, false, gateWidth);
+  associate();
+  return count;
+}
+
+void LD2410Candidates::findPeaks(const LD2410Parser::ValuesArray &signals, const LD2410Parser::ValuesArray &thresholds,
+                                 bool moving, byte gateWidth)
+{
+  const byte *e = signals.values;
+  for (byte g = 0; g <= signals.N; g++)
+  {
+    // gates beyond the maximum gate never count as above the threshold
+    if ((g > thresholds.N) || (e[g] < thresholds.values[g]))
+      continue;
+    // a plateau counts once, at its first gate
+    if (((g > 0) && (e[g - 1] >= e[g])) || ((g < signals.N) && (e[g + 1] > e[g])))
+      continue;
+    // non-maximum suppression: the list is kept sorted by energy, strongest first
+    bool suppressed = false;
+    for (byte i = 0; i < count && !suppressed; i++)
+    {
+      byte d = (list[i].gate > g) ? list[i].gate - g : g - list[i].gate;
+      suppressed = (list[i].moving == moving) && (d < separation) && (list[i].energy >= e[g]);
+    }
+    if (suppressed)
+      continue;
+    byte pos = count;
+    while ((pos > 0) && (list[pos - 1].energy < e[g]))
+      pos--;
+    if (pos >= LD2410_MAX_CANDIDATES)
+      continue;
+    if (count < LD2410_MAX_CANDIDATES)
+      count++;
+    for (byte i = count - 1; i > pos; i--)
+      list[i] = list[i - 1];
+    Candidate &c = list[pos];
+    c.id = 0;
+    c.gate = g;
+    c.distance = (unsigned long)g * gateWidth + gateWidth / 2;
+    c.energy = e[g];
+    c.moving = moving;
+    c.age = 1;
+    // weaker peaks of the same type next to the new one are dropped
+    for (byte i = pos + 1; i < count;)
+    {
+      byte d = (list[i].gate > g) ? list[i].gate - g : g - list[i].gate;
+      if ((list[i].moving == moving) && (d < separation))
+      {
+        for (byte j = i; j + 1 < count; j++)
+          list[j] = list[j + 1];
+        count--;
+      }
+      else
+        i++;
+    }
+  }
+}
+
+void LD2410Candidates::associate()
+{
+  bool taken[LD2410_MAX_CANDIDATES] = {false};
+  // strongest first: a strong candidate claims its nearest predecessor
+  for (byte i = 0; i < count; i++)
+  {
+    Candidate &c = list[i];
+    byte best = LD2410_MAX_CANDIDATES;
+    byte bestD = 0;
+    for (byte j = 0; j < previousCount; j++)
+    {
+      if (taken[j] || (previous[j].moving != c.moving))
+        continue;
+      byte d = (previous[j].gate > c.gate) ? previous[j].gate - c.gate : c.gate - previous[j].gate;
+      if ((d <= step) && ((best == LD2410_MAX_CANDIDATES) || (d < bestD)))
+      {
+        best = j;
+        bestD = d;
+      }
+    }
+    if (best < LD2410_MAX_CANDIDATES)
+    {
+      taken[best] = true;
+      c.id = previous[best].id;
+      c.age = (previous[best].age < 0xFF) ? previous[best].age + 1 : 0xFF;
+    }
+    else
+    {
+      c.id = nextId++;
+      if (!nextId)
+        nextId = 1;
+    }
+  }
+}
+
+byte LD2410Candidates::size() const
+{
+  return count;
+}
+
+const LD2410Candidates::Candidate &LD2410Candidates::operator[](byte i) const
+{
+  return list[(i < count) ? i : 0];
+}
+
+void LD2410Candidates::clear()
+{
+  count = 0;
+  previousCount = 0;
+}
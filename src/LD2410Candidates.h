@@ -0,0 +1,94 @@
+#ifndef LD2410_CANDIDATES_H
+#define LD2410_CANDIDATES_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Candidates.h
+ */
+
+#include "LD2410Parser.h"
+
+#ifndef LD2410_MAX_CANDIDATES
+#define LD2410_MAX_CANDIDATES 6
+#endif
+
+/**
+ * @brief Multiple target candidates from the enhanced-mode gate energies.
+ *
+ * A frame reports a single moving and a single stationary target. This stage finds all
+ * local energy maxima above the gate thresholds (up to the maximum gate), keeps only the strongest one within
+ * minSeparation gates (non-maximum suppression, per energy type), and associates the
+ * candidates with those of the previous frame, so that a candidate keeps its id while
+ * it moves by at most maxStep gates per frame. Fixed storage, no allocation.
+ */
+class LD2410Candidates
+{
+public:
+  struct Candidate
+  {
+    byte id;                // stable across frames while the candidate is associated, never 0
+    byte gate;              // the gate of the energy peak
+    unsigned long distance; // the centre of the gate [cm]
+    byte energy;            // the peak energy
+    bool moving;            // true: moving energy; false: stationary energy
+    byte age;               // the number of consecutive frames the candidate has been seen (saturates)
+  };
+
+  /**
+   * @brief Construct a new LD2410Candidates object
+   *
+   * @param minSeparation - peaks closer than this [gates] are merged into the stronger one
+   * @param maxStep - the largest movement [gates] between frames that keeps the id
+   */
+  LD2410Candidates(byte minSeparation = 2, byte maxStep = 1);
+
+  /**
+   * @brief Extract the candidates of an enhanced-mode frame
+   *
+   * @param data - the frame
+   * @param movingThresholds - sensor.getMovingThresholds()
+   * @param stationaryThresholds - sensor.getStationaryThresholds()
+   * @param gateWidth - sensor.getResolution() [cm]
+   * @return byte - the number of candidates (0 for a basic-mode frame)
+   */
+  byte update(const LD2410Parser::SensorData &data,
+              const LD2410Parser::ValuesArray &movingThresholds,
+              const LD2410Parser::ValuesArray &stationaryThresholds,
+              byte gateWidth);
+
+  /**
+   * @brief Get the number of candidates of the latest frame
+   */
+  byte size() const;
+
+  /**
+   * @brief Get a candidate of the latest frame, strongest first
+   */
+  const Candidate &operator[](byte i) const;
+
+  /**
+   * @brief Forget all candidates and their ids
+   */
+  void clear();
+
+private:
+  Candidate list[LD2410_MAX_CANDIDATES];
+  Candidate previous[LD2410_MAX_CANDIDATES];
+  byte count = 0;
+  byte previousCount = 0;
+  byte nextId = 1;
+  byte separation;
+  byte step;
+  void findPeaks(const LD2410Parser::ValuesArray &signals, const LD2410Parser::ValuesArray &thresholds,
+                 bool moving, byte gateWidth);
+  void associate();
+};
+
+#endif // LD2410_CANDIDATES_H
@@ -0,0 +1,107 @@
+#include "LD2410Drift.h"
+
+namespace
+{
+  // the baseline is trusted after a few EWMA time constants
+  const unsigned long warmupConstants = 3;
+  // never recommend thresholds outside this range
+  const byte minThreshold = 10;
+  const byte maxThreshold = 100;
+}
+
+LD2410Drift::LD2410Drift(byte margin, byte hysteresis, unsigned long minInterval, byte k, byte shift)
+    : margin(margin), hysteresis(hysteresis), minInterval(minInterval), k(k), shift(shift)
+{
+  reset();
+}
+
+void LD2410Drift::update(const MyLD2410::SensorData &data, bool empty)
+{
+  if (!empty || !data.mTargetSignals.N)
+    return;
+  const MyLD2410::ValuesArray *signals[2] = {&data.sTargetSignals, &data.mTargetSignals};
+  for (byte t = 0; t < 2; t++)
+  {
+    unsigned int present = (1U << (signals[t]->N + 1)) - 1;
+    // learn only the gates seen in every frame since the first one
+    masks[t] = learned ? (masks[t] & present) : present;
+    for (byte g = 0; g <= signals[t]->N; g++)
+    {
+      LD2410Baseline &gate = gates[t][g];
+      if (!learned) // start from the first frame instead of zero
+        gate.seed(signals[t]->values[g]);
+      else if (masks[t] & (1U << g))
+        gate.learn(gate.deviation(signals[t]->values[g]), shift);
+    }
+  }
+  learned++;
+}
+
+bool LD2410Drift::ready() const
+{
+  return learned >= (warmupConstants << shift);
+}
+
+byte LD2410Drift::recommended(byte gate, bool moving) const
+{
+  if ((gate > 8) || !(masks[moving ? 1 : 0] & (1U << gate)))
+    return 0xFF;
+  const LD2410Baseline &g = gates[moving ? 1 : 0][gate];
+  unsigned long level = (g.mean() + 128) / 256 + g.spread(k) + margin;
+  if (level < minThreshold)
+    return minThreshold;
+  return (level > maxThreshold) ? maxThreshold : byte(level);
+}
+
+bool LD2410Drift::drifted(byte current, byte target) const
+{
+  byte d = (current > target) ? current - target : target - current;
+  return d > hysteresis;
+}
+
+#ifndef LD2410_NO_PROFILE
+bool LD2410Drift::maintain(MyLD2410 &sensor, byte *sent)
+{
+  if (sent)
+    *sent = 0;
+  if (!ready() || (pushed && (millis() - lastPush < minInterval)))
+    return false;
+  const MyLD2410::ValuesArray &moving = sensor.getMovingThresholds();
+  const MyLD2410::ValuesArray &stationary = sensor.getStationaryThresholds();
+  MyLD2410::DeviceProfile profile; // everything else is left unchanged
+  bool changes = false;
+  for (byte g = 0; g < 9; g++)
+  {
+    byte m = recommended(g, true);
+    byte s = recommended(g, false);
+    // gates that were never learned keep their current thresholds
+    if ((m != 0xFF) && drifted(moving.values[g], m))
+    {
+      profile.movingThresholds.values[g] = m;
+      changes = true;
+    }
+    if ((s != 0xFF) && drifted(stationary.values[g], s))
+    {
+      profile.stationaryThresholds.values[g] = s;
+      changes = true;
+    }
+  }
+  if (!changes)
+    return false;
+  // rate-limit failed attempts too
+  pushed = true;
+  lastPush = millis();
+  return sensor.applyProfile(profile, sent);
+}
+#endif
+
+void LD2410Drift::reset()
+{
+  for (byte t = 0; t < 2; t++)
+  {
+    masks[t] = 0;
+    for (byte g = 0; g < 9; g++)
+      gates[t][g].reset();
+  }
+  learned = 0;
+}
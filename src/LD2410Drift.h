@@ -0,0 +1,99 @@
+#ifndef LD2410_DRIFT_H
+#define LD2410_DRIFT_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Drift.h
+ */
+
+#include "MyLD2410.h"
+#include "LD2410Baseline.h"
+
+/**
+ * @brief Keeps the gate thresholds matched to a slowly drifting empty-room baseline.
+ *
+ * update() learns a slow EWMA mean and variance of every gate energy from enhanced-mode frames
+ * while the room is known to be empty. The recommended threshold of a gate is
+ * mean + k standard deviations + margin. maintain(), called from loop(), pushes the recommended
+ * thresholds to the sensor only for the gates that are off by more than the hysteresis,
+ * all in one config session (MyLD2410::applyProfile()), and at most once per minInterval.
+ * Only the gates present in every frame since the first one (up to the maximum gate) are learned
+ * and maintained; the others keep their thresholds. Call reset() after raising the maximum gate.
+ */
+class LD2410Drift
+{
+public:
+  /**
+   * @brief Construct a new LD2410Drift object
+   *
+   * @param margin - added to the baseline mean + k standard deviations
+   * @param hysteresis - a gate is updated only if its threshold is off by more than this
+   * @param minInterval - the minimum time between updates of the sensor [ms]
+   * @param k - the baseline spread in standard deviations
+   * @param shift - the EWMA weight is 1/2^shift per frame (10: a time constant of ~100s at 10 frames/s)
+   */
+  LD2410Drift(byte margin = 10, byte hysteresis = 8, unsigned long minInterval = 3600000UL, byte k = 3, byte shift = 10);
+
+  /**
+   * @brief Feed a decoded frame; basic-mode frames are ignored
+   *
+   * @param data - the frame
+   * @param empty - true if the room is known to be empty
+   */
+  void update(const MyLD2410::SensorData &data, bool empty);
+
+  /**
+   * @brief Check whether the baseline has learned from enough empty frames to be used
+   */
+  bool ready() const;
+
+  /**
+   * @brief Get the recommended threshold of a gate
+   *
+   * @param gate - the gate [0..8]
+   * @param moving - true for the moving threshold, false for the stationary threshold
+   * @return byte - the threshold, or 0xFF if the gate has not been learned
+   * (it lies beyond the maximum gate of the frames)
+   */
+  byte recommended(byte gate, bool moving) const;
+
+#ifndef LD2410_NO_PROFILE
+  /**
+   * @brief Push the recommended thresholds if they have drifted. Call from loop(), not from a data callback.
+   * Nothing is sent unless the baseline is ready, minInterval has passed since the last push,
+   * and at least one gate is off by more than the hysteresis.
+   *
+   * @param sensor - the sensor
+   * @param sent - receives the number of threshold commands sent (optional)
+   * @return true if the sensor was updated
+   */
+  bool maintain(MyLD2410 &sensor, byte *sent = nullptr);
+#endif
+
+  /**
+   * @brief Forget the baseline
+   */
+  void reset();
+
+private:
+  LD2410Baseline gates[2][9]; // [0] stationary, [1] moving
+  unsigned int masks[2];      // the learned gates, bit g = gate g
+  unsigned long learned = 0;
+  unsigned long lastPush = 0;
+  bool pushed = false;
+  byte margin;
+  byte hysteresis;
+  unsigned long minInterval;
+  byte k;
+  byte shift;
+  bool drifted(byte current, byte target) const;
+};
+
+#endif // LD2410_DRIFT_H
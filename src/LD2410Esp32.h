@@ -0,0 +1,116 @@
+#ifndef LD2410_ESP32_H
+#define LD2410_ESP32_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Esp32.h
+ */
+
+#include "MyLD2410.h"
+
+#if defined(ESP32)
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+/**
+ * @brief Event-driven reception on ESP32, instead of polling check() from loop().
+ *
+ * Registers with HardwareSerial::onReceive(): the UART driver task reads the received
+ * bytes, passes them to MyLD2410::feed(), and notifies the application task only when
+ * a data frame has been decoded. The application blocks in wait() until then.
+ *
+ * While reception is running, do not call check() or send commands to the sensor;
+ * call end() first, and begin() again afterwards. feed() runs no command-sending jobs:
+ * the adaptive mode policy pauses, and begin() refuses while an autoThresholds() job runs.
+ */
+class LD2410Esp32
+{
+public:
+  /**
+   * @brief Construct a new LD2410Esp32 object
+   *
+   * @param sensor - the sensor driver, after a successful sensor.begin()
+   * @param serial - the hardware UART of the sensor
+   */
+  LD2410Esp32(MyLD2410 &sensor, HardwareSerial &serial) : sensor(sensor), serial(serial) {}
+
+  /**
+   * @brief Start the event-driven reception
+   *
+   * @param task - the task to notify of new data frames [the calling task]
+   * @return false if a background auto-thresholds job is running
+   */
+  bool begin(TaskHandle_t task = nullptr)
+  {
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+    if (sensor.autoThresholdsRunning())
+      return false;
+#endif
+    notify = task ? task : xTaskGetCurrentTaskHandle();
+    // deliver a frame as soon as the line goes idle after it
+    serial.setRxTimeout(1);
+    serial.onReceive([this]()
+                     { receive(); },
+                     false);
+    return true;
+  }
+
+  /**
+   * @brief Stop the event-driven reception
+   */
+  void end()
+  {
+    serial.onReceive(NULL);
+  }
+
+  /**
+   * @brief Block the calling task until a data frame has been decoded
+   *
+   * @param data - receives a copy of the latest sensor data
+   * @param timeout - the maximum waiting time [ticks]
+   * @return true if new data was received; false on timeout
+   */
+  bool wait(MyLD2410::SensorData &data, TickType_t timeout = portMAX_DELAY)
+  {
+    if (!ulTaskNotifyTake(pdTRUE, timeout))
+      return false;
+    portENTER_CRITICAL(&lock);
+    data = latest;
+    portEXIT_CRITICAL(&lock);
+    return true;
+  }
+
+private:
+  MyLD2410 &sensor;
+  HardwareSerial &serial;
+  TaskHandle_t notify = nullptr;
+  portMUX_TYPE lock = portMUX_INITIALIZER_UNLOCKED;
+  MyLD2410::SensorData latest;
+
+  void receive()
+  {
+    byte chunk[LD2410_BUFFER_SIZE];
+    bool data = false;
+    size_t n;
+    while ((n = serial.read(chunk, sizeof(chunk))) > 0)
+      if (sensor.feed(chunk, n) == MyLD2410::DATA)
+        data = true;
+    if (!data)
+      return;
+    portENTER_CRITICAL(&lock);
+    latest = sensor.getSensorData();
+    portEXIT_CRITICAL(&lock);
+    xTaskNotifyGive(notify);
+  }
+};
+
+#endif // ESP32
+
+#endif // LD2410_ESP32_H
@@ -0,0 +1,195 @@
+#include "LD2410Health.h"
+
+namespace
+{
+  // the window over which frame loss and parse errors are evaluated [ms]
+  const unsigned long healthWindow = 2000UL;
+  // a config session without a command reply for this long is stuck (three ack timeouts) [ms]
+  const unsigned long configSilence = 6000UL;
+}
+
+LD2410Health::LD2410Health(MyLD2410 &sensor, unsigned long stallTime, unsigned long backoff, unsigned long maxBackoff)
+    : sensor(sensor), stallTime(stallTime), backoff(backoff), maxBackoff(maxBackoff) {}
+
+void LD2410Health::onState(StateCallback callback, void *context)
+{
+  stateCallback = callback;
+  stateContext = context;
+}
+
+void LD2410Health::onIncident(IncidentCallback callback, void *context)
+{
+  incidentCallback = callback;
+  incidentContext = context;
+}
+
+void LD2410Health::setState(State state)
+{
+  bool changed = (state != current) || (state == RECOVERING);
+  current = state;
+  if (changed && stateCallback)
+    stateCallback(current, currentStep, stateContext);
+}
+
+unsigned long LD2410Health::errors()
+{
+#ifndef LD2410_NO_STATISTICS
+  MyLD2410::Statistics stats = sensor.getStatistics();
+  return stats.tailErrors + stats.lengthErrors + stats.malformedFrames + stats.timeouts;
+#else
+  return 0;
+#endif
+}
+
+LD2410Health::State LD2410Health::poll()
+{
+  unsigned long now = millis();
+  unsigned long n = sensor.getFrameCount();
+  if (n != frames)
+  {
+    frames = n;
+    lastFrame = now;
+    if ((current == STALLED) || (current == RECOVERING))
+    { // back: close the incident
+      incident.end = now;
+      incident.downtime = now - incident.start;
+      last = incident;
+      count++;
+      downtime += incident.downtime;
+      currentStep = NO_STEP;
+      windowStart = now;
+      windowFrames = frames;
+      windowErrors = errors();
+      setState(OK);
+      if (incidentCallback)
+        incidentCallback(last, incidentContext);
+      return current;
+    }
+  }
+  if ((current == STALLED) || (current == RECOVERING))
+  {
+    if ((long)(now - nextStep) >= 0)
+      recover(now);
+    return current;
+  }
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  if (sensor.autoThresholdsRunning())
+  { // the job keeps the sensor in config mode, and waits for the room to empty without commands
+    lastFrame = now;
+    windowStart = now;
+    windowFrames = frames;
+    return current;
+  }
+#endif
+  if (sensor.inConfigMode())
+  { // a config session of the sketch: the sensor sends no data, but replies to commands
+    unsigned long reply = sensor.getLastReplyTime();
+    if (now - reply <= configSilence)
+    {
+      lastFrame = now;
+      windowStart = now;
+      windowFrames = frames;
+      return current;
+    }
+    lastFrame = reply;
+  }
+  unsigned long limit = sensor.getFramePeriod() * 5 / 1000;
+  if (limit < stallTime)
+    limit = stallTime;
+  if (now - lastFrame > limit)
+  {
+    incident = Incident();
+    incident.start = lastFrame;
+    currentStep = NO_STEP;
+    wait = backoff;
+    nextStep = now;
+    setState(STALLED);
+    return current;
+  }
+  evaluate(now);
+  return current;
+}
+
+void LD2410Health::evaluate(unsigned long now)
+{
+  if (now - windowStart < healthWindow)
+    return;
+  unsigned long period = sensor.getFramePeriod();
+  unsigned long received = frames - windowFrames;
+  unsigned long e = errors();
+  unsigned long failed = e - windowErrors;
+  // more than 20% of the expected frames missing, or more than one error per 5 frames
+  unsigned long expected = period ? ((now - windowStart) * 1000UL) / period : received;
+  bool degraded = (received * 5 < expected * 4) || (failed * 5 > received);
+  windowStart = now;
+  windowFrames = frames;
+  windowErrors = e;
+  setState(degraded ? DEGRADED : OK);
+}
+
+void LD2410Health::recover(unsigned long now)
+{
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  if (sensor.autoThresholdsRunning())
+  { // do not break into the job: try again once it has finished
+    nextStep = now + wait;
+    return;
+  }
+#endif
+  if ((currentStep == NO_STEP) && sensor.inConfigMode())
+    currentStep = RESYNC; // stuck in config mode: start with resync(true)
+  if (currentStep < BEGIN)
+    currentStep = Step(currentStep + 1);
+  incident.step = currentStep;
+  incident.attempts++;
+  setState(RECOVERING);
+  switch (currentStep)
+  {
+  case RESYNC:
+    sensor.resync();
+    break;
+  case CONFIG_DISABLE:
+    sensor.resync(true);
+    break;
+  case REBOOT:
+    sensor.requestReboot();
+    break;
+  default:
+    sensor.begin();
+    break;
+  }
+  // the step may have blocked for a while
+  now = millis();
+  nextStep = now + wait;
+  wait = (wait > maxBackoff / 2) ? maxBackoff : wait * 2;
+}
+
+LD2410Health::State LD2410Health::state() const
+{
+  return current;
+}
+
+LD2410Health::Step LD2410Health::step() const
+{
+  return currentStep;
+}
+
+unsigned long LD2410Health::incidents() const
+{
+  return count;
+}
+
+unsigned long LD2410Health::totalDowntime() const
+{
+  return downtime;
+}
+
+unsigned long LD2410Health::meanTimeToRecovery() const
+{
+  return count ? downtime / count : 0;
+}
+
+const LD2410Health::Incident &LD2410Health::lastIncident() const
+{
+  return last;
+}
@@ -0,0 +1,146 @@
+#ifndef LD2410_HEALTH_H
+#define LD2410_HEALTH_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Health.h
+ */
+
+#include "MyLD2410.h"
+
+/**
+ * @brief Watches the data stream of a sensor and recovers it when it stalls.
+ *
+ * Call poll() from loop(), after sensor.check(). The link is DEGRADED when more than a fifth of the
+ * expected frames are missing, or parse errors are frequent; STALLED when no frame has arrived
+ * for stallTime (or 5 frame periods, whichever is longer). A stall is an incident: the monitor
+ * escalates through resync, config-disable, reboot and begin(), repeating begin(), with the wait
+ * between the steps doubling from backoff up to maxBackoff (RECOVERING). The incident ends with
+ * the first new frame, and its downtime is reported. Config sessions opened by the sketch
+ * are not counted as stalls while the sensor keeps replying: a session without a reply for
+ * three ack timeouts (6s) is a stall, and its recovery starts with the config-disable step.
+ * A running background auto-thresholds job is never a stall, and no recovery step interrupts it.
+ */
+class LD2410Health
+{
+public:
+  enum State
+  {
+    OK = 0,
+    DEGRADED,
+    STALLED,
+    RECOVERING
+  };
+  enum Step
+  {
+    NO_STEP = 0,
+    RESYNC,         // flush the serial buffer and the parser
+    CONFIG_DISABLE, // leave a config session the sensor may be stuck in
+    REBOOT,         // MyLD2410::requestReboot()
+    BEGIN           // MyLD2410::begin(), repeated until the sensor is back
+  };
+  struct Incident
+  {
+    unsigned long start = 0;    // the last frame before the stall [ms]
+    unsigned long end = 0;      // the first frame after the recovery [ms]
+    unsigned long downtime = 0; // [ms]
+    Step step = NO_STEP;        // the last recovery step taken
+    unsigned int attempts = 0;  // the number of recovery steps taken
+  };
+  typedef void (*StateCallback)(State state, Step step, void *context);
+  typedef void (*IncidentCallback)(const Incident &incident, void *context);
+
+  /**
+   * @brief Construct a new LD2410Health object
+   *
+   * @param sensor - the monitored sensor
+   * @param stallTime - the minimum time without frames that counts as a stall [ms]
+   * @param backoff - the wait after the first recovery step [ms]
+   * @param maxBackoff - the longest wait between recovery steps [ms]
+   */
+  LD2410Health(MyLD2410 &sensor, unsigned long stallTime = 1000, unsigned long backoff = 500, unsigned long maxBackoff = 60000);
+
+  /**
+   * @brief Call the callback on every state change and recovery step
+   */
+  void onState(StateCallback callback, void *context = nullptr);
+
+  /**
+   * @brief Call the callback at the end of every incident
+   */
+  void onIncident(IncidentCallback callback, void *context = nullptr);
+
+  /**
+   * @brief Evaluate the link and take the next recovery step when due. Call from loop().
+   *
+   * @return State - the current state
+   */
+  State poll();
+
+  /**
+   * @brief Get the current state
+   */
+  State state() const;
+
+  /**
+   * @brief Get the latest recovery step of the current incident
+   */
+  Step step() const;
+
+  /**
+   * @brief Get the number of finished incidents
+   */
+  unsigned long incidents() const;
+
+  /**
+   * @brief Get the total downtime of the finished incidents [ms]
+   */
+  unsigned long totalDowntime() const;
+
+  /**
+   * @brief Get the mean time to recovery [ms], 0 without incidents
+   */
+  unsigned long meanTimeToRecovery() const;
+
+  /**
+   * @brief Get the latest finished incident
+   */
+  const Incident &lastIncident() const;
+
+private:
+  MyLD2410 &sensor;
+  unsigned long stallTime;
+  unsigned long backoff;
+  unsigned long maxBackoff;
+  StateCallback stateCallback = nullptr;
+  void *stateContext = nullptr;
+  IncidentCallback incidentCallback = nullptr;
+  void *incidentContext = nullptr;
+  State current = OK;
+  Step currentStep = NO_STEP;
+  Incident incident;
+  Incident last;
+  unsigned long count = 0;
+  unsigned long downtime = 0;
+  unsigned long frames = 0;
+  unsigned long lastFrame = 0;
+  unsigned long wait = 0;
+  unsigned long nextStep = 0;
+  // the degradation window
+  unsigned long windowStart = 0;
+  unsigned long windowFrames = 0;
+  unsigned long windowErrors = 0;
+  void setState(State state);
+  void recover(unsigned long now);
+  void evaluate(unsigned long now);
+  unsigned long errors();
+};
+
+#endif // LD2410_HEALTH_H
@@ -0,0 +1,229 @@
+#ifndef LD2410_HEATMAP_H
+#define LD2410_HEATMAP_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Heatmap.h
+ */
+
+#include "LD2410Parser.h"
+
+/**
+ * @brief A rolling gate x time buffer of the enhanced-mode gate energies.
+ *
+ * The energies are stored per gate, each gate in its own contiguous ring of FRAMES bytes
+ * (moving and stationary separately), so a gate can be read out or reduced without
+ * gathering bytes from every frame. append() takes O(1); the oldest frame is overwritten.
+ * Each frame takes 18 energy bytes and a timestamp: sizeof(LD2410Heatmap<FRAMES>) is about
+ * FRAMES * (18 + sizeof(unsigned long)), i.e. 22 bytes per frame on AVR and ESP32.
+ *
+ * Feed it from the data callback:
+ * @code
+ * LD2410Heatmap<600> heatmap; // 1 minute at 10 frames/s, 13.2kB on AVR and ESP32
+ * void onFrame(const MyLD2410::SensorData &data, void *) { heatmap.append(data); }
+ * sensor.onData(onFrame);
+ * @endcode
+ *
+ * @tparam FRAMES - the number of frames kept
+ */
+template <unsigned int FRAMES>
+class LD2410Heatmap
+{
+public:
+  static const byte GATES = 9;
+
+  /**
+   * @brief A view of one gate row: the older part, followed by the newer part
+   */
+  struct Span
+  {
+    const byte *first;
+    unsigned int firstSize;
+    const byte *second;
+    unsigned int secondSize;
+  };
+
+  /**
+   * @brief Store the gate energies of an enhanced-mode frame
+   *
+   * @return true on success; false for a basic-mode frame (no gate energies)
+   */
+  bool append(const LD2410Parser::SensorData &data)
+  {
+    if (!data.mTargetSignals.N)
+      return false;
+    for (byte g = 0; g < GATES; g++)
+    {
+      moving[g][head] = (g <= data.mTargetSignals.N) ? data.mTargetSignals.values[g] : 0;
+      stationary[g][head] = (g <= data.sTargetSignals.N) ? data.sTargetSignals.values[g] : 0;
+    }
+    times[head] = data.timestamp;
+    if (++head == FRAMES)
+      head = 0;
+    if (count < FRAMES)
+      count++;
+    return true;
+  }
+
+  /**
+   * @brief Drop all stored frames
+   */
+  void clear()
+  {
+    head = 0;
+    count = 0;
+  }
+
+  /**
+   * @brief Get the number of stored frames
+   */
+  unsigned int size() const
+  {
+    return count;
+  }
+
+  /**
+   * @brief Get the capacity in frames
+   */
+  unsigned int capacity() const
+  {
+    return FRAMES;
+  }
+
+  /**
+   * @brief Get a stored energy value
+   *
+   * @param gate - the gate [0..8]
+   * @param frame - the frame, 0 = the oldest stored frame
+   * @param isMoving - true for the moving energy, false for the stationary energy
+   */
+  byte value(byte gate, unsigned int frame, bool isMoving = true) const
+  {
+    return row(gate, isMoving)[index(frame)];
+  }
+
+  /**
+   * @brief Get the timestamp [ms] of a stored frame (0 = the oldest stored frame)
+   */
+  unsigned long timestamp(unsigned int frame) const
+  {
+    return times[index(frame)];
+  }
+
+  /**
+   * @brief Get a gate row in chronological order without copying it.
+   * The data stays valid until the next append().
+   *
+   * @param gate - the gate [0..8]
+   * @param isMoving - true for the moving energies, false for the stationary energies
+   */
+  Span gateRow(byte gate, bool isMoving = true) const
+  {
+    const byte *r = row(gate, isMoving);
+    unsigned int start = index(0);
+    Span s;
+    s.first = r + start;
+    s.firstSize = (start + count <= FRAMES) ? count : FRAMES - start;
+    s.second = r;
+    s.secondSize = count - s.firstSize;
+    return s;
+  }
+
+  /**
+   * @brief Get the frame timestamps in chronological order without copying them
+   *
+   * @param first, firstSize, second, secondSize - receive the two parts of the ring
+   */
+  void timestamps(const unsigned long *&first, unsigned int &firstSize,
+                  const unsigned long *&second, unsigned int &secondSize) const
+  {
+    unsigned int start = index(0);
+    first = times + start;
+    firstSize = (start + count <= FRAMES) ? count : FRAMES - start;
+    second = times;
+    secondSize = count - firstSize;
+  }
+
+  /**
+   * @brief Reduce a gate row to blocks of blockMs (e.g. 1000 for per-second values).
+   * Blocks are aligned to the oldest stored frame; empty blocks are skipped.
+   *
+   * @param gate - the gate [0..8]
+   * @param isMoving - true for the moving energies, false for the stationary energies
+   * @param blockMs - the block length [ms]
+   * @param maxOut - receives the maximum per block (may be nullptr)
+   * @param meanOut - receives the mean per block (may be nullptr)
+   * @param blocks - the capacity of the output arrays
+   * @return unsigned int - the number of blocks written
+   */
+  unsigned int downsample(byte gate, bool isMoving, unsigned long blockMs,
+                          byte *maxOut, byte *meanOut, unsigned int blocks) const
+  {
+    if (!count || !blocks || !blockMs)
+      return 0;
+    const byte *r = row(gate, isMoving);
+    unsigned long blockEnd = times[index(0)] + blockMs;
+    unsigned int n = 0, frames = 0;
+    unsigned long sum = 0;
+    byte peak = 0;
+    for (unsigned int f = 0; f < count; f++)
+    {
+      unsigned int i = index(f);
+      if ((long)(times[i] - blockEnd) >= 0)
+      {
+        if (frames)
+        {
+          store(maxOut, meanOut, n++, peak, sum, frames);
+          if (n == blocks)
+            return n;
+        }
+        while ((long)(times[i] - blockEnd) >= 0)
+          blockEnd += blockMs;
+        sum = frames = peak = 0;
+      }
+      sum += r[i];
+      frames++;
+      if (r[i] > peak)
+        peak = r[i];
+    }
+    store(maxOut, meanOut, n++, peak, sum, frames);
+    return n;
+  }
+
+private:
+  byte moving[GATES][FRAMES];
+  byte stationary[GATES][FRAMES];
+  unsigned long times[FRAMES];
+  unsigned int head = 0;
+  unsigned int count = 0;
+
+  const byte *row(byte gate, bool isMoving) const
+  {
+    if (gate >= GATES)
+      gate = GATES - 1;
+    return isMoving ? moving[gate] : stationary[gate];
+  }
+
+  unsigned int index(unsigned int frame) const
+  {
+    unsigned int i = head + FRAMES - count + frame;
+    return (i >= FRAMES) ? i - FRAMES : i;
+  }
+
+  static void store(byte *maxOut, byte *meanOut, unsigned int n, byte peak, unsigned long sum, unsigned int frames)
+  {
+    if (maxOut)
+      maxOut[n] = peak;
+    if (meanOut)
+      meanOut[n] = (sum + frames / 2) / frames;
+  }
+};
+
+#endif // LD2410_HEATMAP_H
@@ -0,0 +1,38 @@
+#include "LD2410Interpolation.h"
+
+bool LD2410Interpolation::refine(const LD2410Parser::ValuesArray &signals, byte gateWidth, Estimate &estimate)
+{
+  estimate.valid = false;
+  if (!signals.N || !gateWidth)
+    return false;
+  byte p = 0;
+  for (byte g = 1; g <= signals.N; g++)
+    if (signals.values[g] > signals.values[p])
+      p = g;
+  int peak = signals.values[p];
+  // a missing neighbour (beyond the first or last gate) mirrors the other one
+  int left = (p > 0) ? signals.values[p - 1] : -1;
+  int right = (p < signals.N) ? signals.values[p + 1] : -1;
+  if (left < 0)
+    left = (right < 0) ? peak : right;
+  if (right < 0)
+    right = left;
+  // vertex of the parabola through (-1, left), (0, peak), (1, right): 0.5 (right - left) / (2 peak - left - right)
+  int curvature = 2 * peak - left - right; // >= 0, the peak is a maximum
+  long offset = 0;
+  if (curvature)
+    offset = (long(right - left) * 128) / curvature;
+  if (offset > 128)
+    offset = 128;
+  else if (offset < -128)
+    offset = -128;
+  estimate.gate = p;
+  estimate.offset = int(offset);
+  long position = long(p) * 256 + 128 + offset; // the centre of gate p is at p + 0.5 gates
+  estimate.distance = (unsigned long)((position * gateWidth + 128) / 256);
+  // half the curvature, i.e. how far the peak rises above its neighbours on average
+  int confidence = (curvature + 1) / 2;
+  estimate.confidence = (confidence > 100) ? 100 : byte(confidence);
+  estimate.valid = true;
+  return true;
+}
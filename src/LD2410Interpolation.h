@@ -0,0 +1,64 @@
+#ifndef LD2410_INTERPOLATION_H
+#define LD2410_INTERPOLATION_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Interpolation.h
+ */
+
+#include "LD2410Parser.h"
+
+/**
+ * @brief Sub-gate distance estimates from the enhanced-mode gate energies.
+ *
+ * The reported target distances are limited by the gate width (75cm, or 20cm in fine resolution).
+ * The energy peak is refined by fitting a parabola through the strongest gate and its two
+ * neighbours. Integer arithmetic only, so it is cheap enough for every frame on AVR.
+ */
+class LD2410Interpolation
+{
+public:
+  struct Estimate
+  {
+    unsigned long distance = 0; // [cm], from the sensor to the refined peak
+    byte gate = 0;              // the strongest gate
+    int offset = 0;             // the peak position relative to the gate centre [1/256 gate]
+    byte confidence = 0;        // 0..100: how strong and sharp the peak is
+    bool valid = false;
+  };
+
+  /**
+   * @brief Refine the energy peak of one gate energy array
+   *
+   * @param signals - the gate energies (mTargetSignals or sTargetSignals)
+   * @param gateWidth - the gate width [cm], as returned by MyLD2410::getResolution()
+   * @param estimate - receives the result
+   * @return true on success; false if there are no gate energies (basic mode)
+   */
+  static bool refine(const LD2410Parser::ValuesArray &signals, byte gateWidth, Estimate &estimate);
+
+  /**
+   * @brief Refine the moving target of a frame
+   */
+  static bool moving(const LD2410Parser::SensorData &data, byte gateWidth, Estimate &estimate)
+  {
+    return refine(data.mTargetSignals, gateWidth, estimate);
+  }
+
+  /**
+   * @brief Refine the stationary target of a frame
+   */
+  static bool stationary(const LD2410Parser::SensorData &data, byte gateWidth, Estimate &estimate)
+  {
+    return refine(data.sTargetSignals, gateWidth, estimate);
+  }
+};
+
+#endif // LD2410_INTERPOLATION_H
@@ -0,0 +1,126 @@
+#include "LD2410NoOneTuner.h"
+
+LD2410NoOneTuner::LD2410NoOneTuner(byte percentile, unsigned int minGaps, unsigned int maxGap)
+    : percentile(percentile), minGaps(minGaps), maxGap(maxGap * 1000UL)
+{
+  reset();
+}
+
+void LD2410NoOneTuner::setThresholds(const MyLD2410::ValuesArray &moving, const MyLD2410::ValuesArray &stationary)
+{
+  for (byte g = 0; g < 9; g++)
+  {
+    movingThresholds[g] = (g <= moving.N) ? moving.values[g] : 0xFF;
+    stationaryThresholds[g] = (g <= stationary.N) ? stationary.values[g] : 0xFF;
+  }
+  hasThresholds = true;
+}
+
+void LD2410NoOneTuner::setMinEnergy(byte energy)
+{
+  minEnergy = energy;
+}
+
+bool LD2410NoOneTuner::evidence(const MyLD2410::SensorData &data) const
+{
+  if (hasThresholds && data.mTargetSignals.N)
+  {
+    for (byte g = 0; g <= data.mTargetSignals.N; g++)
+      if (data.mTargetSignals.values[g] >= movingThresholds[g])
+        return true;
+    for (byte g = 0; g <= data.sTargetSignals.N; g++)
+      if (data.sTargetSignals.values[g] >= stationaryThresholds[g])
+        return true;
+    return false;
+  }
+  return ((data.status & 1) && (data.mTargetSignal >= minEnergy)) ||
+         ((data.status & 2) && (data.sTargetSignal >= minEnergy));
+}
+
+void LD2410NoOneTuner::update(const MyLD2410::SensorData &data)
+{
+  if (data.status > 3)
+    return;
+  unsigned long now = data.timestamp;
+  if (!evidence(data))
+  {
+    inGap = seen;
+    return;
+  }
+  if (inGap)
+  {
+    unsigned long gap = now - lastEvidence;
+    if (gap <= maxGap)
+      add(gap);
+    inGap = false;
+  }
+  seen = true;
+  lastEvidence = now;
+}
+
+void LD2410NoOneTuner::add(unsigned long ms)
+{
+  unsigned long s = (ms + 500) / 1000;
+  histogram[(s < MAX_WINDOW) ? s : MAX_WINDOW]++;
+  count++;
+  // age the history, so that the tuner follows a change of use
+  if (++total >= 0x4000)
+  {
+    total = 0;
+    for (byte i = 0; i <= MAX_WINDOW; i++)
+    {
+      histogram[i] /= 2;
+      total += histogram[i];
+    }
+  }
+}
+
+unsigned long LD2410NoOneTuner::gaps() const
+{
+  return count;
+}
+
+byte LD2410NoOneTuner::recommended() const
+{
+  if ((count < minGaps) || !total)
+    return 0;
+  unsigned long target = (total * percentile + 99) / 100;
+  unsigned long sum = 0;
+  byte s = 0;
+  for (; s < MAX_WINDOW; s++)
+  {
+    sum += histogram[s];
+    if (sum >= target)
+      break;
+  }
+  s++; // bridge the whole bucket
+  if (s < 2)
+    s = 2;
+  return (s > MAX_WINDOW) ? MAX_WINDOW : s;
+}
+
+#ifndef LD2410_NO_SETTERS
+bool LD2410NoOneTuner::apply(MyLD2410 &sensor, unsigned long minInterval)
+{
+  byte window = recommended();
+  if (!window || (applied && (millis() - lastApply < minInterval)))
+    return false;
+  byte current = sensor.getNoOneWindow();
+  byte d = (window > current) ? window - current : current - window;
+  if ((d < 2) || (d * 5 < current))
+    return false;
+  applied = true;
+  lastApply = millis();
+  return sensor.setNoOneWindow(window);
+}
+#endif
+
+void LD2410NoOneTuner::reset()
+{
+  for (byte i = 0; i <= MAX_WINDOW; i++)
+    histogram[i] = 0;
+  total = 0;
+  count = 0;
+  seen = false;
+  inGap = false;
+}
@@ -0,0 +1,108 @@
+#ifndef LD2410_NO_ONE_TUNER_H
+#define LD2410_NO_ONE_TUNER_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410NoOneTuner.h
+ */
+
+#include "MyLD2410.h"
+
+/**
+ * @brief Learns how long the target evidence disappears while someone is still in the room,
+ * and recommends a no-one window that bridges most of those gaps.
+ *
+ * A frame carries evidence when a gate energy reaches its threshold (enhanced mode, with
+ * thresholds set), or else when the moving or stationary target energy reaches minEnergy.
+ * This is independent of the reported status, which the sensor itself holds for the no-one window.
+ * A gap without evidence that ends with evidence within maxGap is counted as an occupied gap;
+ * longer gaps are departures and are not counted. The recommendation is the chosen percentile
+ * of the occupied gaps plus one second.
+ */
+class LD2410NoOneTuner
+{
+public:
+  static const byte MAX_WINDOW = 60;
+
+  /**
+   * @brief Construct a new LD2410NoOneTuner object
+   *
+   * @param percentile - the share of occupied gaps to bridge [%]
+   * @param minGaps - the number of observed gaps before a recommendation is made
+   * @param maxGap - gaps longer than this are departures [s]
+   */
+  LD2410NoOneTuner(byte percentile = 95, unsigned int minGaps = 20, unsigned int maxGap = 300);
+
+  /**
+   * @brief Use the gate energies and thresholds for the evidence (enhanced mode)
+   *
+   * @param moving - sensor.getMovingThresholds()
+   * @param stationary - sensor.getStationaryThresholds()
+   */
+  void setThresholds(const MyLD2410::ValuesArray &moving, const MyLD2410::ValuesArray &stationary);
+
+  /**
+   * @brief Set the target energy that counts as evidence without gate thresholds
+   */
+  void setMinEnergy(byte energy);
+
+  /**
+   * @brief Feed a decoded frame
+   */
+  void update(const MyLD2410::SensorData &data);
+
+  /**
+   * @brief Get the number of occupied gaps observed
+   */
+  unsigned long gaps() const;
+
+  /**
+   * @brief Get the recommended no-one window [s], 0 if not enough gaps have been observed
+   */
+  byte recommended() const;
+
+#ifndef LD2410_NO_SETTERS
+  /**
+   * @brief Write the recommended no-one window, if it differs meaningfully from the current one
+   * (by at least 2s and 20%), and at most once per minInterval. Call from loop().
+   *
+   * @param sensor - the sensor
+   * @param minInterval - the minimum time between writes [ms]
+   * @return true if a new window was written
+   */
+  bool apply(MyLD2410 &sensor, unsigned long minInterval = 3600000UL);
+#endif
+
+  /**
+   * @brief Forget the observed gaps
+   */
+  void reset();
+
+private:
+  unsigned int histogram[MAX_WINDOW + 1]; // 1s buckets, the last one collects longer gaps
+  unsigned long total = 0;
+  unsigned long count = 0;
+  byte movingThresholds[9];
+  byte stationaryThresholds[9];
+  bool hasThresholds = false;
+  byte minEnergy = 20;
+  byte percentile;
+  unsigned int minGaps;
+  unsigned long maxGap;
+  bool seen = false;
+  bool inGap = false;
+  unsigned long lastEvidence = 0;
+  unsigned long lastApply = 0;
+  bool applied = false;
+  bool evidence(const MyLD2410::SensorData &data) const;
+  void add(unsigned long ms);
+};
+
+#endif // LD2410_NO_ONE_TUNER_H
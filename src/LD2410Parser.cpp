@@ -0,0 +1,218 @@
+#include "LD2410Parser.h"
+#include <string.h>
+
+const byte LD2410Parser::headData[4]{0xF4, 0xF3, 0xF2, 0xF1};
+const byte LD2410Parser::tailData[4]{0xF8, 0xF7, 0xF6, 0xF5};
+const byte LD2410Parser::headConfig[4]{0xFD, 0xFC, 0xFB, 0xFA};
+const byte LD2410Parser::tailConfig[4]{4, 3, 2, 1};
+
+LD2410Parser::Event LD2410Parser::push(byte b)
+{
+  counters.bytes++;
+  switch (state)
+  {
+  case SYNC:
+    syncBytes++;
+    if (matched && (b == (isData ? headData : headConfig)[matched]))
+    {
+      if (++matched == 4)
+        headerFound();
+    }
+    else if (b == headData[0])
+    {
+      isData = true;
+      matched = 1;
+    }
+    else if (b == headConfig[0])
+    {
+      isData = false;
+      matched = 1;
+    }
+    else
+      matched = 0;
+    break;
+  case LENGTH:
+    buf[bufI++] = b;
+    if (bufI == 2)
+    {
+      expected = buf[0] | (buf[1] << 8);
+      bufI = 0;
+      if (lengthOk())
+        state = BODY;
+    }
+    break;
+  case BODY:
+    buf[bufI++] = b;
+    if (bufI == expected)
+      return complete(buf);
+    break;
+  }
+  return NONE;
+}
+
+size_t LD2410Parser::feed(const byte *data, size_t size, Event &event)
+{
+  size_t i = 0;
+  event = NONE;
+  while (i < size)
+  {
+    if ((state == LENGTH) && (bufI == 0) && (size - i >= 2))
+    { // the length field is in the chunk: try to take the whole frame in place
+      expected = data[i] | (data[i + 1] << 8);
+      if ((size - i - 2) >= expected + 4)
+      {
+        counters.bytes += 2;
+        i += 2;
+        if (!lengthOk())
+          continue;
+        counters.bytes += expected;
+        const byte *body = data + i;
+        i += expected;
+        event = complete(body);
+        if (event != NONE)
+          return i;
+        continue;
+      }
+    }
+    event = push(data[i++]);
+    if (event != NONE)
+      return i;
+  }
+  return i;
+}
+
+void LD2410Parser::headerFound()
+{
+  // the four header bytes belong to the frame, everything before them was skipped
+  if (syncBytes > 4)
+    counters.discarded += syncBytes - 4;
+  syncBytes = 0;
+  matched = 0;
+  bufI = 0;
+  state = LENGTH;
+}
+
+bool LD2410Parser::lengthOk()
+{
+  if ((expected == 0) || (expected + 4 > LD2410_BUFFER_SIZE))
+  {
+    counters.lengthErrors++;
+    state = SYNC;
+    return false;
+  }
+  expected += 4;
+  return true;
+}
+
+LD2410Parser::Event LD2410Parser::complete(const byte *body)
+{
+  state = SYNC;
+  bufI = 0;
+  if (memcmp(body + expected - 4, isData ? tailData : tailConfig, 4))
+  {
+    counters.tailErrors++;
+    return NONE;
+  }
+  if (isData && !(((body[0] == 1) || (body[0] == 2)) && (body[1] == 0xAA)))
+  {
+    counters.malformedFrames++;
+    return NONE;
+  }
+  frameBuf = body;
+  lastSize = expected;
+  lastEvent = isData ? DATA : ACK;
+  return lastEvent;
+}
+
+const byte *LD2410Parser::frame() const
+{
+  return frameBuf;
+}
+
+byte LD2410Parser::frameSize() const
+{
+  return lastSize;
+}
+
+bool LD2410Parser::decode(SensorData &data) const
+{
+  return (lastEvent == DATA) && decodeData(frameBuf, lastSize, data);
+}
+
+bool LD2410Parser::decode(Ack &ack) const
+{
+  if ((lastEvent != ACK) || (lastSize < 8))
+    return false;
+  ack.command = frameBuf[0] | (frameBuf[1] << 8);
+  ack.status = frameBuf[2] | (frameBuf[3] << 8);
+  ack.data = frameBuf + 4;
+  ack.size = lastSize - 8;
+  return true;
+}
+
+bool LD2410Parser::decodeData(const byte *payload, byte size, SensorData &data)
+{
+  if (size < 15)
+    return false;
+  data.status = payload[2] & 7;
+  data.mTargetDistance = payload[3] | (payload[4] << 8);
+  data.mTargetSignal = payload[5];
+  data.sTargetDistance = payload[6] | (payload[7] << 8);
+  data.sTargetSignal = payload[8];
+  data.distance = payload[9] | (payload[10] << 8);
+  if (payload[0] == 1)
+  { // Enhanced mode only
+    data.mTargetSignals.setN(payload[11]);
+    data.sTargetSignals.setN(payload[12]);
+    if (size < 4 + 13 + data.mTargetSignals.N + data.sTargetSignals.N + 4)
+      return false;
+    const byte *p = payload + 13;
+    for (byte i = 0; i <= data.mTargetSignals.N; i++)
+      data.mTargetSignals.values[i] = *(p++);
+    for (byte i = 0; i <= data.sTargetSignals.N; i++)
+      data.sTargetSignals.values[i] = *(p++);
+    data.lightLevel = *(p++);
+    data.outLevel = *p;
+  }
+  else
+  { // Basic mode only
+    data.mTargetSignals.setN(0);
+    data.sTargetSignals.setN(0);
+    data.lightLevel = 0;
+    data.outLevel = 0;
+  }
+  return true;
+}
+
+bool LD2410Parser::receivingData() const
+{
+  return isData && (state == BODY);
+}
+
+byte LD2410Parser::received() const
+{
+  return (state == BODY) ? bufI : 0;
+}
+
+void LD2410Parser::reset()
+{
+  state = SYNC;
+  matched = 0;
+  bufI = 0;
+}
+
+const byte *LD2410Parser::partial() const
+{
+  return buf;
+}
+
+const LD2410Parser::Counters &LD2410Parser::getCounters() const
+{
+  return counters;
+}
+
+void LD2410Parser::resetCounters()
+{
+  counters = Counters();
+  syncBytes = 0;
+}
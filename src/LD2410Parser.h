@@ -0,0 +1,230 @@
+#ifndef LD2410_PARSER_H
+#define LD2410_PARSER_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Parser.h
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+typedef uint8_t byte;
+#endif
+#include "MyLD2410Config.h"
+
+#ifndef LD2410_BUFFER_SIZE
+#define LD2410_BUFFER_SIZE 0x40
+#endif
+
+/**
+ * @brief A transport-independent parser for the LD2410 serial protocol.
+ *
+ * Bytes are fed one at a time with push(), or in chunks with feed(), from any source:
+ * a UART, a DMA buffer, a BLE notification, a network bridge or a recorded file.
+ * The parser keeps no clock and does not depend on Stream, so it also builds on a host.
+ */
+class LD2410Parser
+{
+public:
+  enum Event
+  {
+    NONE = 0,
+    DATA,
+    ACK
+  };
+  struct ValuesArray
+  {
+    byte values[9];
+    byte N = 0;
+
+    void setN(byte n)
+    {
+      N = (n <= 8) ? n : 8;
+    }
+    ValuesArray &operator=(const ValuesArray &other)
+    {
+      if (this != &other)
+      {
+        N = other.N;
+        for (byte i = 0; i <= N; i++)
+          values[i] = other.values[i];
+      }
+      return *this;
+    }
+    template <typename ByteHandler>
+    void forEach(ByteHandler func) const
+    {
+      for (byte i = 0; i <= N; i++)
+        func(values[i]);
+    }
+  };
+  struct SensorData
+  {
+    byte status;
+    unsigned long timestamp;
+    unsigned long mTargetDistance;
+    byte mTargetSignal;
+    unsigned long sTargetDistance;
+    byte sTargetSignal;
+    unsigned long distance;
+    // Enhanced data
+    ValuesArray mTargetSignals;
+    ValuesArray sTargetSignals;
+    byte lightLevel;
+    byte outLevel;
+    // Timing, filled in by the receiver
+    unsigned long timestampUs; // micros() at the arrival of the first header byte
+    byte missedFrames;         // estimated number of frames lost right before this one
+  };
+  /**
+   * @brief A command reply, pointing into the frame it was decoded from
+   */
+  struct Ack
+  {
+    unsigned int command; // the command word with the reply bit set (e.g. 0x1FF)
+    unsigned int status;  // 0 on success
+    const byte *data;     // the reply parameters following the status
+    byte size;            // the number of reply parameter bytes
+  };
+  /**
+   * @brief Parser counters
+   */
+  struct Counters
+  {
+    unsigned long bytes = 0;           // all bytes pushed into the parser
+    unsigned long discarded = 0;       // bytes skipped while searching for a frame header
+    unsigned long tailErrors = 0;      // frames with a wrong tail
+    unsigned long lengthErrors = 0;    // frames with a zero or too large length field
+    unsigned long malformedFrames = 0; // data frames with an unknown type/marker
+  };
+
+  static const byte headData[4];
+  static const byte tailData[4];
+  static const byte headConfig[4];
+  static const byte tailConfig[4];
+
+  /**
+   * @brief Push a single byte into the parser
+   *
+   * @return LD2410Parser::DATA or LD2410Parser::ACK when the byte completed a valid frame;
+   * LD2410Parser::NONE otherwise
+   */
+  Event push(byte b);
+
+  /**
+   * @brief Feed a chunk of bytes into the parser.
+   * Parsing stops right after the first complete frame, so that it can be handled;
+   * call again with the remaining bytes. Frames that lie entirely inside the chunk
+   * are not copied - frame() then points into the chunk itself.
+   *
+   * @param data - the chunk
+   * @param size - the number of bytes in the chunk
+   * @param event - receives the event of the last consumed byte
+   * @return size_t - the number of bytes consumed
+   */
+  size_t feed(const byte *data, size_t size, Event &event);
+
+  /**
+   * @brief Get the last complete frame: the payload followed by the 4-byte tail.
+   * Valid until the next call to push() or feed(), or as long as the fed chunk.
+   */
+  const byte *frame() const;
+
+  /**
+   * @brief Get the size of the last complete frame (payload and tail)
+   */
+  byte frameSize() const;
+
+  /**
+   * @brief Decode the last complete frame as data
+   *
+   * @return true if the last frame was a data frame
+   */
+  bool decode(SensorData &data) const;
+
+  /**
+   * @brief Decode the last complete frame as a command reply
+   *
+   * @return true if the last frame was a command reply
+   */
+  bool decode(Ack &ack) const;
+
+  /**
+   * @brief Decode a data frame payload (as returned by frame())
+   *
+   * @return true on success
+   */
+  static bool decodeData(const byte *payload, byte size, SensorData &data);
+
+  /**
+   * @brief Check whether the parser is between frames (no header bytes matched)
+   */
+  bool idle() const
+  {
+    return (state == SYNC) && !matched;
+  }
+
+  /**
+   * @brief Check whether the payload of a data frame is being received
+   */
+  bool receivingData() const;
+
+  /**
+   * @brief Get the number of payload bytes of the current frame received so far
+   */
+  byte received() const;
+
+  /**
+   * @brief Get the payload bytes of the frame in progress; received() of them are valid
+   */
+  const byte *partial() const;
+
+  /**
+   * @brief Drop the frame in progress and search for the next header
+   */
+  void reset();
+
+  /**
+   * @brief Get the parser counters
+   */
+  const Counters &getCounters() const;
+
+  /**
+   * @brief Reset the parser counters to zero
+   */
+  void resetCounters();
+
+private:
+  enum State
+  {
+    SYNC,
+    LENGTH,
+    BODY
+  };
+  byte buf[LD2410_BUFFER_SIZE];
+  const byte *frameBuf = buf;
+  byte lastSize = 0;
+  Event lastEvent = NONE;
+  State state = SYNC;
+  bool isData = false;
+  byte matched = 0;
+  byte bufI = 0;
+  unsigned int expected = 0; // payload + tail bytes of the current frame
+  unsigned long syncBytes = 0;
+  Counters counters;
+  void headerFound();
+  bool lengthOk();
+  Event complete(const byte *body);
+};
+
+#endif // LD2410_PARSER_H
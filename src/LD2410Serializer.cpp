@@ -0,0 +1,309 @@
+#include "LD2410Serializer.h"
+
+LD2410Serializer::LD2410Serializer(byte *buffer, size_t size, Format format)
+    : buf(buffer), out(nullptr), limit(size), format(format) {}
+
+LD2410Serializer::LD2410Serializer(Print &out, size_t limit, Format format)
+    : buf(nullptr), out(&out), limit(limit), format(format) {}
+
+LD2410Serializer::Format LD2410Serializer::getFormat() const
+{
+  return format;
+}
+
+void LD2410Serializer::begin(bool dryRun)
+{
+  n = 0;
+  pending = 0;
+  overflow = false;
+  first = true;
+  measuring = dryRun;
+}
+
+size_t LD2410Serializer::end()
+{
+  if (overflow)
+    return 0;
+  if (buf && (format == JSON) && (n < limit))
+    buf[n] = 0;
+  if (pending)
+    out->write(chunk, pending);
+  return n;
+}
+
+bool LD2410Serializer::fits(size_t maxSize) const
+{
+  // neither a Print nor the caller's buffer may see part of a record: measure first, unless it always fits
+  return maxSize <= limit;
+}
+
+void LD2410Serializer::put(byte b)
+{
+  if (n >= limit)
+  {
+    overflow = true;
+    return;
+  }
+  if (!measuring)
+  {
+    if (buf)
+      buf[n] = b;
+    else
+    {
+      chunk[pending++] = b;
+      if (pending == sizeof(chunk))
+      {
+        out->write(chunk, pending);
+        pending = 0;
+      }
+    }
+  }
+  n++;
+}
+
+void LD2410Serializer::put(const char *s)
+{
+  while (*s)
+    put(byte(*(s++)));
+}
+
+void LD2410Serializer::number(unsigned long value)
+{
+  char digits[11];
+  byte i = 0;
+  do
+  {
+    digits[i++] = '0' + (value % 10);
+    value /= 10;
+  } while (value);
+  while (i)
+    put(byte(digits[--i]));
+}
+
+void LD2410Serializer::hex(unsigned long value, byte digits)
+{
+  while (digits--)
+    put(byte("0123456789ABCDEF"[(value >> (4 * digits)) & 0xF]));
+}
+
+void LD2410Serializer::cborHead(byte major, unsigned long value)
+{
+  major <<= 5;
+  if (value < 24)
+    put(major | byte(value));
+  else if (value < 0x100)
+  {
+    put(major | 24);
+    put(byte(value));
+  }
+  else if (value < 0x10000UL)
+  {
+    put(major | 25);
+    put(byte(value >> 8));
+    put(byte(value));
+  }
+  else
+  {
+    put(major | 26);
+    for (int shift = 24; shift >= 0; shift -= 8)
+      put(byte(value >> shift));
+  }
+}
+
+void LD2410Serializer::beginMap(byte size)
+{
+  if (format == CBOR)
+    cborHead(5, size);
+  else
+    put('{');
+  first = true;
+}
+
+void LD2410Serializer::endMap()
+{
+  if (format == JSON)
+    put('}');
+  first = false;
+}
+
+void LD2410Serializer::key(const char *k)
+{
+  if (format == CBOR)
+  {
+    cborHead(3, strlen(k));
+    put(k);
+    return;
+  }
+  if (!first)
+    put(',');
+  first = false;
+  put('"');
+  put(k);
+  put("\":");
+}
+
+void LD2410Serializer::field(const char *k, unsigned long value)
+{
+  key(k);
+  if (format == CBOR)
+    cborHead(0, value);
+  else
+    number(value);
+}
+
+void LD2410Serializer::values(const char *k, const MyLD2410::ValuesArray &array)
+{
+  key(k);
+  if (format == CBOR)
+    cborHead(4, array.N + 1);
+  else
+    put('[');
+  for (byte i = 0; i <= array.N; i++)
+  {
+    if (format == CBOR)
+      cborHead(0, array.values[i]);
+    else
+    {
+      if (i)
+        put(',');
+      number(array.values[i]);
+    }
+  }
+  if (format == JSON)
+    put(']');
+}
+
+void LD2410Serializer::target(const char *k, unsigned long distance, byte energy)
+{
+  key(k);
+  beginMap(2);
+  field("distance", distance);
+  field("energy", energy);
+  endMap();
+}
+
+void LD2410Serializer::le(unsigned long value, byte bytes)
+{
+  for (byte i = 0; i < bytes; i++, value >>= 8)
+    put(byte(value));
+}
+
+size_t LD2410Serializer::write(const MyLD2410::SensorData &data)
+{
+  if (!fits(MAX_DATA_SIZE))
+  {
+    begin(true);
+    encode(data);
+    if (overflow)
+      return 0;
+  }
+  begin();
+  encode(data);
+  return end();
+}
+
+void LD2410Serializer::encode(const MyLD2410::SensorData &data)
+{
+  bool enhanced = data.mTargetSignals.N > 0;
+  if (format == BINARY)
+  {
+    put(BINARY_VERSION);
+    put(data.status);
+    le(data.timestamp, 4);
+    le(data.mTargetDistance, 2);
+    put(data.mTargetSignal);
+    le(data.sTargetDistance, 2);
+    put(data.sTargetSignal);
+    le(data.distance, 2);
+    put(enhanced ? 1 : 0);
+    for (byte i = 0; i < 9; i++)
+      put((enhanced && (i <= data.mTargetSignals.N)) ? data.mTargetSignals.values[i] : 0);
+    for (byte i = 0; i < 9; i++)
+      put((enhanced && (i <= data.sTargetSignals.N)) ? data.sTargetSignals.values[i] : 0);
+    put(enhanced ? data.lightLevel : 0);
+    put(enhanced ? data.outLevel : 0);
+    return;
+  }
+  beginMap(enhanced ? 9 : 5);
+  field("status", data.status);
+  field("timestamp", data.timestamp);
+  field("distance", data.distance);
+  target("moving", data.mTargetDistance, data.mTargetSignal);
+  target("stationary", data.sTargetDistance, data.sTargetSignal);
+  if (enhanced)
+  {
+    values("movingSignals", data.mTargetSignals);
+    values("stationarySignals", data.sTargetSignals);
+    field("light", data.lightLevel);
+    field("out", data.outLevel);
+  }
+  endMap();
+}
+
+size_t LD2410Serializer::write(MyLD2410 &sensor)
+{
+  if (format == BINARY)
+    return 0;
+  if (!fits(MAX_INFO_SIZE))
+  {
+    begin(true);
+    encode(sensor);
+    if (overflow)
+      return 0;
+  }
+  begin();
+  encode(sensor);
+  return end();
+}
+
+void LD2410Serializer::encode(MyLD2410 &sensor)
+{
+  byte major = sensor.getFirmwareMajor();
+  byte minor = sensor.getFirmwareMinor();
+  unsigned long build = sensor.getFirmwareBuild();
+#ifndef LD2410_NO_BLUETOOTH
+  const byte *mac = sensor.getMAC();
+  beginMap(5);
+#else
+  beginMap(4);
+#endif
+  key("firmware");
+  if (format == CBOR)
+  { // "M.mm.bbbbbbbb"
+    byte size = ((major < 0x10) ? 1 : 2) + 1 + 2 + 1 + 8;
+    cborHead(3, size);
+  }
+  else
+    put('"');
+  hex(major, (major < 0x10) ? 1 : 2);
+  put('.');
+  hex(minor, 2);
+  put('.');
+  hex(build, 8);
+  if (format == JSON)
+    put('"');
+  field("protocol", sensor.getVersion());
+#ifndef LD2410_NO_BLUETOOTH
+  key("mac");
+  if (format == CBOR)
+  {
+    cborHead(2, 6);
+    for (byte i = 0; i < 6; i++)
+      put(mac[i]);
+  }
+  else
+  {
+    put('"');
+    for (byte i = 0; i < 6; i++)
+    {
+      if (i)
+        put(':');
+      hex(mac[i], 2);
+    }
+    put('"');
+  }
+#endif
+  field("resolution", sensor.getResolution());
+  field("range", sensor.getRange_cm());
+  endMap();
+}
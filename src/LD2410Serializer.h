@@ -0,0 +1,122 @@
+#ifndef LD2410_SERIALIZER_H
+#define LD2410_SERIALIZER_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Serializer.h
+ */
+
+#include "MyLD2410.h"
+
+/**
+ * @brief Serializes sensor data and device info as JSON, CBOR or a fixed binary layout,
+ * straight into a caller-provided buffer or a Print (e.g. a network client), without heap use.
+ *
+ * Output never exceeds the given size: a record that does not fit is reported as 0 bytes,
+ * and nothing of it is written. When the size is below the largest possible record, the record
+ * is measured in a dry run first, so a failed write leaves the buffer untouched. In buffer mode
+ * every call starts writing at the beginning of the buffer, and JSON is NUL-terminated when
+ * there is room for it. In Print mode the output is written in chunks of up to 32 bytes.
+ */
+class LD2410Serializer
+{
+public:
+  enum Format
+  {
+    JSON = 0,
+    CBOR,
+    BINARY
+  };
+
+  /**
+   * @brief The size of a BINARY record, all fields little-endian:
+   * version(1) status(1) timestamp(4) mTargetDistance(2) mTargetSignal(1) sTargetDistance(2)
+   * sTargetSignal(1) distance(2) enhanced(1) mTargetSignals(9) sTargetSignals(9) lightLevel(1) outLevel(1)
+   */
+  static const byte BINARY_SIZE = 35;
+  static const byte BINARY_VERSION = 1;
+  /**
+   * @brief The largest possible data record and device info record in any format (JSON, without the NUL)
+   */
+  static const size_t MAX_DATA_SIZE = 274;
+  static const size_t MAX_INFO_SIZE = 102;
+
+  /**
+   * @brief Serialize into a buffer
+   *
+   * @param buffer - the output buffer
+   * @param size - the size of the buffer
+   * @param format - JSON, CBOR or BINARY
+   */
+  LD2410Serializer(byte *buffer, size_t size, Format format = JSON);
+
+  /**
+   * @brief Serialize into a Print
+   *
+   * @param out - the output
+   * @param limit - the maximum number of bytes written per record
+   * @param format - JSON, CBOR or BINARY
+   */
+  LD2410Serializer(Print &out, size_t limit = 0xFFFF, Format format = JSON);
+
+  /**
+   * @brief Serialize a data frame. The gate energies and the light/output levels
+   * are included for enhanced-mode frames only (always present in BINARY).
+   *
+   * @return size_t - the number of bytes written; 0 if the record did not fit
+   */
+  size_t write(const MyLD2410::SensorData &data);
+
+  /**
+   * @brief Serialize the device info: firmware, protocol version, MAC address, resolution and range.
+   * Values not yet read from the sensor are requested first, so call it outside time-critical code.
+   * BINARY is not supported for device info.
+   *
+   * @return size_t - the number of bytes written; 0 if the record did not fit
+   */
+  size_t write(MyLD2410 &sensor);
+
+  /**
+   * @brief Get the output format
+   */
+  Format getFormat() const;
+
+private:
+  byte *buf;
+  Print *out;
+  size_t limit;
+  Format format;
+  size_t n = 0;
+  bool overflow = false;
+  bool first = true;
+  bool measuring = false;
+  byte chunk[32];
+  byte pending = 0;
+
+  void begin(bool dryRun = false);
+  size_t end();
+  bool fits(size_t maxSize) const;
+  void encode(const MyLD2410::SensorData &data);
+  void encode(MyLD2410 &sensor);
+  void put(byte b);
+  void put(const char *s);
+  void number(unsigned long value);
+  void hex(unsigned long value, byte digits);
+  void cborHead(byte major, unsigned long value);
+  void beginMap(byte size);
+  void endMap();
+  void key(const char *k);
+  void field(const char *k, unsigned long value);
+  void values(const char *k, const MyLD2410::ValuesArray &array);
+  void target(const char *k, unsigned long distance, byte energy);
+  void le(unsigned long value, byte bytes);
+};
+
+#endif // LD2410_SERIALIZER_H
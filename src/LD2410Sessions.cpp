@@ -0,0 +1,137 @@
+#include "LD2410Sessions.h"
+
+LD2410Sessions::LD2410Sessions(byte noOneWindow) : noOne(noOneWindow * 1000UL)
+{
+  resetHistograms();
+}
+
+void LD2410Sessions::setNoOneWindow(byte noOneWindow)
+{
+  noOne = noOneWindow * 1000UL;
+}
+
+void LD2410Sessions::setMinEnergy(byte energy)
+{
+  minEnergy = energy;
+}
+
+void LD2410Sessions::onSession(SessionCallback callback, void *context)
+{
+  this->callback = callback;
+  this->context = context;
+}
+
+LD2410Sessions::Event LD2410Sessions::update(const LD2410Parser::SensorData &data)
+{
+  unsigned long now = data.timestamp;
+  bool present = (data.status >= 1) && (data.status <= 3);
+  if (present)
+  {
+    bool evidence = ((data.status & 1) && (data.mTargetSignal >= minEnergy)) ||
+                    ((data.status & 2) && (data.sTargetSignal >= minEnergy));
+    if (open && absent)
+    { // back within the merge window: the same session
+      absent = false;
+      quiet = false;
+      session.merged++;
+      return NONE;
+    }
+    if (open)
+    {
+      if (!evidence && !quiet)
+      {
+        quiet = true;
+        quietSince = now;
+      }
+      else if (evidence && quiet)
+      { // the sensor held the presence through the gap
+        quiet = false;
+        if (now - quietSince >= 1000)
+          session.bridged++;
+      }
+      return NONE;
+    }
+    open = true;
+    absent = false;
+    quiet = false;
+    session = Session();
+    session.start = now;
+    if (hasStart)
+      add(arrival, now - lastStart);
+    lastStart = now;
+    hasStart = true;
+    return raise(START);
+  }
+  if (!open || (data.status > 3))
+    return NONE;
+  if (!absent)
+  {
+    absent = true;
+    quiet = false; // the gap was the departure
+    absentSince = now;
+    return NONE;
+  }
+  if (now - absentSince < noOne)
+    return NONE;
+  // the sensor held the presence for its no-one window after the departure
+  open = false;
+  absent = false;
+  session.end = (absentSince - session.start > noOne) ? absentSince - noOne : session.start;
+  add(dwell, session.end - session.start);
+  count++;
+  return raise(END);
+}
+
+LD2410Sessions::Event LD2410Sessions::raise(Event event)
+{
+  if (callback)
+    callback(event, session, context);
+  return event;
+}
+
+void LD2410Sessions::add(unsigned int *histogram, unsigned long ms)
+{
+  unsigned long s = ms / 1000;
+  byte b = 0;
+  while ((s >>= 1) && (b < BUCKETS - 1))
+    b++;
+  if (histogram[b] < 0xFFFF)
+    histogram[b]++;
+}
+
+bool LD2410Sessions::occupied() const
+{
+  return open;
+}
+
+const LD2410Sessions::Session &LD2410Sessions::current() const
+{
+  return session;
+}
+
+unsigned long LD2410Sessions::sessions() const
+{
+  return count;
+}
+
+const unsigned int *LD2410Sessions::dwellHistogram() const
+{
+  return dwell;
+}
+
+const unsigned int *LD2410Sessions::arrivalHistogram() const
+{
+  return arrival;
+}
+
+unsigned long LD2410Sessions::bucketStart(byte bucket)
+{
+  return bucket ? (1UL << bucket) : 0;
+}
+
+void LD2410Sessions::resetHistograms()
+{
+  for (byte b = 0; b < BUCKETS; b++)
+    dwell[b] = arrival[b] = 0;
+  count = 0;
+}
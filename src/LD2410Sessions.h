@@ -0,0 +1,137 @@
+#ifndef LD2410_SESSIONS_H
+#define LD2410_SESSIONS_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Sessions.h
+ */
+
+#include "LD2410Parser.h"
+
+/**
+ * @brief Turns the presence status of the frames into occupancy sessions.
+ *
+ * The sensor reports absence only after its no-one window has expired. A session therefore
+ * ends noOneWindow seconds before the absence is reported; and a presence that returns
+ * within one more no-one window is counted as a merged gap of the same session, not as a
+ * new arrival. Session end is confirmed (and reported) once that merge window has passed.
+ *
+ * The gaps that the sensor bridges itself never show in the status. They are found from the
+ * target energies instead, with the rule LD2410NoOneTuner uses without gate thresholds:
+ * a stretch of at least 1s in which neither reported target reaches minEnergy, while presence
+ * is still reported, and which ends with target energy again.
+ *
+ * Dwell times and inter-arrival times are counted in log2 buckets of seconds:
+ * bucket 0 holds [0, 2)s, bucket i holds [2^i, 2^(i+1))s, the last bucket holds everything longer.
+ */
+class LD2410Sessions
+{
+public:
+  static const byte BUCKETS = 16;
+  enum Event
+  {
+    NONE = 0,
+    START, // a new session started
+    END    // the session ended (reported after the merge window)
+  };
+  struct Session
+  {
+    unsigned long start = 0;  // the first frame with presence [ms]
+    unsigned long end = 0;    // the estimated departure [ms], 0 while the session is open
+    unsigned int bridged = 0; // gaps in the target energy bridged by the sensor's no-one window
+    unsigned int merged = 0;  // reported absences merged into the session within the merge window
+  };
+  typedef void (*SessionCallback)(Event event, const Session &session, void *context);
+
+  /**
+   * @brief Construct a new LD2410Sessions object
+   *
+   * @param noOneWindow - the no-one window of the sensor [s], see MyLD2410::getNoOneWindow()
+   */
+  LD2410Sessions(byte noOneWindow = 5);
+
+  /**
+   * @brief Set the no-one window [s]; call after MyLD2410::setNoOneWindow()
+   */
+  void setNoOneWindow(byte noOneWindow);
+
+  /**
+   * @brief Set the target energy that counts as evidence of presence [20]
+   */
+  void setMinEnergy(byte energy);
+
+  /**
+   * @brief Call the callback on every session start and end
+   */
+  void onSession(SessionCallback callback, void *context = nullptr);
+
+  /**
+   * @brief Feed a decoded frame
+   *
+   * @return Event - START, END or NONE
+   */
+  Event update(const LD2410Parser::SensorData &data);
+
+  /**
+   * @brief Check whether a session is open (including a pending end)
+   */
+  bool occupied() const;
+
+  /**
+   * @brief Get the current session, or the latest one if none is open
+   */
+  const Session &current() const;
+
+  /**
+   * @brief Get the number of finished sessions
+   */
+  unsigned long sessions() const;
+
+  /**
+   * @brief Get the dwell-time histogram: BUCKETS counts
+   */
+  const unsigned int *dwellHistogram() const;
+
+  /**
+   * @brief Get the inter-arrival histogram (start to start): BUCKETS counts
+   */
+  const unsigned int *arrivalHistogram() const;
+
+  /**
+   * @brief Get the lower bound [s] of a histogram bucket
+   */
+  static unsigned long bucketStart(byte bucket);
+
+  /**
+   * @brief Clear the histograms and the session count
+   */
+  void resetHistograms();
+
+private:
+  unsigned long noOne;
+  SessionCallback callback = nullptr;
+  void *context = nullptr;
+  Session session;
+  bool open = false;
+  bool absent = false;           // absence reported, the merge window is running
+  unsigned long absentSince = 0; // when the absence was reported [ms]
+  byte minEnergy = 20;
+  bool quiet = false;           // presence is reported, but without target energy
+  unsigned long quietSince = 0; // [ms]
+  unsigned long lastStart = 0;
+  bool hasStart = false;
+  unsigned long count = 0;
+  unsigned int dwell[BUCKETS];
+  unsigned int arrival[BUCKETS];
+  static void add(unsigned int *histogram, unsigned long ms);
+  Event raise(Event event);
+};
+
+#endif // LD2410_SESSIONS_H
@@ -0,0 +1,150 @@
+#include "LD2410Trace.h"
+
+namespace
+{
+  const char *const kindName[4]{"command", "config", "frame", "wait"};
+  const char *const resultName[3]{"ok", "failed", "timeout"};
+
+#ifndef ARDUINO
+  // the part of Print that exportJson() uses, on a FILE*
+  class FilePrint
+  {
+  public:
+    explicit FilePrint(FILE *file) : file(file) {}
+    size_t print(const char *s) { return put(fprintf(file, "%s", s)); }
+    size_t print(char c) { return put(fprintf(file, "%c", c)); }
+    size_t print(unsigned long value, int base = 10) { return put(fprintf(file, (base == 16) ? "%lX" : "%lu", value)); }
+
+  private:
+    FILE *file;
+    static size_t put(int n) { return (n > 0) ? size_t(n) : 0; }
+  };
+#endif
+
+  template <typename Out>
+  size_t writeJson(const LD2410Trace &trace, Out &out)
+  {
+    // timestamps relative to the earliest start, so that a micros() rollover does not split the timeline
+    unsigned int count = trace.size();
+    unsigned long origin = count ? trace[0].start : 0;
+    long earliest = 0;
+    for (unsigned int i = 1; i < count; i++)
+    {
+      long offset = long(trace[i].start - origin);
+      if (offset < earliest)
+        earliest = offset;
+    }
+    origin += earliest;
+    size_t n = out.print("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    for (unsigned int i = 0; i < count; i++)
+    {
+      const LD2410Trace::Entry &e = trace[i];
+      if (i)
+        n += out.print(',');
+      n += out.print("{\"ph\":\"X\",\"pid\":1,\"tid\":");
+      n += out.print((unsigned long)(e.kind + 1)); // one track per kind
+      n += out.print(",\"cat\":\"");
+      n += out.print(kindName[e.kind & 3]);
+      n += out.print("\",\"name\":\"");
+      switch (e.kind)
+      {
+      case LD2410Trace::COMMAND:
+        n += out.print("0x");
+        n += out.print((unsigned long)e.arg, 16);
+        break;
+      case LD2410Trace::FRAME:
+        n += out.print(e.result ? "enhanced" : "basic");
+        break;
+      default:
+        n += out.print(kindName[e.kind & 3]);
+        break;
+      }
+      n += out.print("\",\"ts\":");
+      n += out.print(e.start - origin);
+      n += out.print(",\"dur\":");
+      n += out.print(e.duration);
+      n += out.print(",\"args\":{");
+      switch (e.kind)
+      {
+      case LD2410Trace::COMMAND:
+        n += out.print("\"command\":");
+        n += out.print((unsigned long)e.arg);
+        n += out.print(",\"result\":\"");
+        n += out.print(resultName[(e.result < 3) ? e.result : 1]);
+        n += out.print('"');
+        break;
+      case LD2410Trace::FRAME:
+        n += out.print("\"status\":");
+        n += out.print((unsigned long)e.arg);
+        break;
+      case LD2410Trace::WAIT:
+        n += out.print("\"ms\":");
+        n += out.print((unsigned long)e.arg);
+        break;
+      }
+      n += out.print("}}");
+    }
+    n += out.print("],\"metadata\":{\"origin\":");
+    n += out.print(origin);
+    n += out.print(",\"dropped\":");
+    n += out.print(trace.dropped());
+    n += out.print("}}");
+    return n;
+  }
+}
+
+LD2410Trace::LD2410Trace(Entry *buffer, unsigned int capacity) : ring(buffer), capacity(capacity) {}
+
+void LD2410Trace::record(Kind kind, unsigned long start, unsigned long duration, unsigned int arg, byte result)
+{
+  if (!capacity)
+    return;
+  Entry &e = ring[head];
+  e.start = start;
+  e.duration = duration;
+  e.arg = arg;
+  e.kind = kind;
+  e.result = result;
+  if (++head == capacity)
+    head = 0;
+  if (count < capacity)
+    count++;
+  else
+    overwritten++;
+}
+
+unsigned int LD2410Trace::size() const
+{
+  return count;
+}
+
+const LD2410Trace::Entry &LD2410Trace::operator[](unsigned int i) const
+{
+  unsigned int index = head + capacity - count + ((i < count) ? i : 0);
+  return ring[(index >= capacity) ? index - capacity : index];
+}
+
+unsigned long LD2410Trace::dropped() const
+{
+  return overwritten;
+}
+
+void LD2410Trace::clear()
+{
+  head = 0;
+  count = 0;
+  overwritten = 0;
+}
+
+#ifdef ARDUINO
+size_t LD2410Trace::exportJson(Print &out) const
+{
+  return writeJson(*this, out);
+}
+#else
+size_t LD2410Trace::exportJson(FILE *out) const
+{
+  FilePrint print(out);
+  return writeJson(*this, print);
+}
+#endif
@@ -0,0 +1,138 @@
+#ifndef LD2410_TRACE_H
+#define LD2410_TRACE_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Trace.h
+ */
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+typedef uint8_t byte;
+#endif
+
+/**
+ * @brief A fixed ring of timeline spans recorded by MyLD2410: every command with its reply latency,
+ * every config session, every decoded data frame, and the pauses of the bulk setters.
+ * The oldest spans are overwritten. Export as Chrome trace-event JSON
+ * (chrome://tracing, https://ui.perfetto.dev) to any Print on the device, e.g. Serial,
+ * or to a FILE* (e.g. stdout) on a host build.
+ *
+ * @code
+ * LD2410TraceBuffer<128> trace;
+ * sensor.setTrace(&trace);
+ * ...
+ * trace.exportJson(Serial);
+ * @endcode
+ */
+class LD2410Trace
+{
+public:
+  enum Kind
+  {
+    COMMAND = 0, // sendCommand(): from writing the command to its reply; arg = command word
+    CONFIG,      // a config session: from the enable reply to the disable (or reboot) reply
+    FRAME,       // a data frame: from its first header byte to the end of decoding; arg = status
+    WAIT         // a fixed pause of a bulk setter; arg = [ms]
+  };
+  enum Result
+  {
+    OK = 0,
+    FAILED, // the reply reported an error
+    TIMEOUT // no reply
+  };
+  struct Entry
+  {
+    unsigned long start;    // micros()
+    unsigned long duration; // [us]
+    unsigned int arg;
+    byte kind;
+    byte result; // COMMAND: Result; FRAME: 1 = enhanced
+  };
+
+  /**
+   * @brief Construct a new LD2410Trace object on caller-provided storage (see LD2410TraceBuffer)
+   *
+   * @param buffer - the ring storage
+   * @param capacity - the number of entries in the buffer
+   */
+  LD2410Trace(Entry *buffer, unsigned int capacity);
+
+  /**
+   * @brief Record a span (called by MyLD2410)
+   */
+  void record(Kind kind, unsigned long start, unsigned long duration, unsigned int arg = 0, byte result = OK);
+
+  /**
+   * @brief Get the number of recorded spans
+   */
+  unsigned int size() const;
+
+  /**
+   * @brief Get a recorded span, 0 = the oldest
+   */
+  const Entry &operator[](unsigned int i) const;
+
+  /**
+   * @brief Get the number of spans overwritten since the last clear()
+   */
+  unsigned long dropped() const;
+
+  /**
+   * @brief Drop all recorded spans
+   */
+  void clear();
+
+#ifdef ARDUINO
+  /**
+   * @brief Write the recorded spans as Chrome trace-event JSON.
+   * Timestamps are relative to the earliest span; metadata.origin holds its micros() value.
+   *
+   * @param out - e.g. Serial
+   * @return size_t - the number of bytes written
+   */
+  size_t exportJson(Print &out) const;
+#else
+  /**
+   * @brief Write the recorded spans as Chrome trace-event JSON (host builds).
+   * Timestamps are relative to the earliest span; metadata.origin holds its micros() value.
+   *
+   * @param out - e.g. stdout
+   * @return size_t - the number of bytes written
+   */
+  size_t exportJson(FILE *out) const;
+#endif
+
+private:
+  Entry *ring;
+  unsigned int capacity;
+  unsigned int head = 0;
+  unsigned int count = 0;
+  unsigned long overwritten = 0;
+};
+
+/**
+ * @brief An LD2410Trace with its own storage for N spans (12 bytes each on AVR, 16 on 32-bit)
+ */
+template <unsigned int N>
+class LD2410TraceBuffer : public LD2410Trace
+{
+public:
+  LD2410TraceBuffer() : LD2410Trace(entries, N) {}
+
+private:
+  Entry entries[N];
+};
+
+#endif // LD2410_TRACE_H
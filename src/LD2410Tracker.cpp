@@ -0,0 +1,121 @@
+#include "LD2410Tracker.h"
+
+LD2410Tracker::LD2410Tracker(Source source, byte alpha, byte beta) : src(source), alpha(alpha), beta(beta) {}
+
+void LD2410Tracker::setThresholds(unsigned int approachSpeed, unsigned int lingerSpeed,
+                                  unsigned long lingerTime, unsigned long lostTime)
+{
+  approach = approachSpeed;
+  linger = lingerSpeed;
+  lingerMs = lingerTime;
+  lostMs = lostTime;
+}
+
+void LD2410Tracker::onEvent(TrackerCallback callback, void *context)
+{
+  this->callback = callback;
+  this->context = context;
+}
+
+bool LD2410Tracker::measure(const LD2410Parser::SensorData &data, unsigned long &z) const
+{
+  switch (src)
+  {
+  case MOVING:
+    z = data.mTargetDistance;
+    return (data.status == 1) || (data.status == 3);
+  case STATIONARY:
+    z = data.sTargetDistance;
+    return (data.status == 2) || (data.status == 3);
+  default:
+    z = data.distance;
+    return (data.status >= 1) && (data.status <= 3);
+  }
+}
+
+LD2410Tracker::Event LD2410Tracker::update(const LD2410Parser::SensorData &data)
+{
+  unsigned long now = data.timestampUs;
+  unsigned long z;
+  if (!measure(data, z))
+  {
+    if (active && ((now - measuredUs) / 1000 >= lostMs))
+    {
+      active = false;
+      motion = NONE;
+      return raise(LOST);
+    }
+    return NONE;
+  }
+  if (!active)
+  {
+    active = true;
+    x = long(z) * 16;
+    v = 0;
+    lastUs = measuredUs = slowSince = now;
+    motion = NONE;
+    return raise(APPEAR);
+  }
+  long dt = long((now - lastUs + 500) / 1000); // [ms]
+  if (dt <= 0)
+    return NONE;
+  if ((unsigned long)dt > lostMs)
+  { // too long without a frame: the velocity is stale
+    v = 0;
+    dt = lostMs;
+  }
+  lastUs = measuredUs = now;
+  // predict, then correct with the residual
+  long predicted = x + v * dt / 1000;
+  long r = long(z) * 16 - predicted;
+  x = predicted + r * alpha / 256;
+  v += (r * beta / 256) * 1000 / dt;
+
+  long speed = (v < 0) ? -v : v;
+  if (speed >= long(linger) * 16)
+    slowSince = now;
+  Event next = motion;
+  if (speed >= long(approach) * 16)
+    next = (v < 0) ? APPROACH : RECEDE;
+  else if ((now - slowSince) / 1000 >= lingerMs)
+    next = LINGER;
+  else if ((motion != LINGER) && (speed < long(linger) * 16))
+    next = NONE;
+  if (next == motion)
+    return NONE;
+  motion = next;
+  return (next == NONE) ? NONE : raise(next);
+}
+
+LD2410Tracker::Event LD2410Tracker::raise(Event event)
+{
+  if (callback)
+    callback(event, *this, context);
+  return event;
+}
+
+bool LD2410Tracker::tracking() const
+{
+  return active;
+}
+
+long LD2410Tracker::distance() const
+{
+  return (x + 8) / 16;
+}
+
+long LD2410Tracker::velocity() const
+{
+  return v / 16;
+}
+
+LD2410Tracker::Event LD2410Tracker::state() const
+{
+  return motion;
+}
+
+void LD2410Tracker::reset()
+{
+  active = false;
+  motion = NONE;
+}
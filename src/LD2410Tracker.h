@@ -0,0 +1,123 @@
+#ifndef LD2410_TRACKER_H
+#define LD2410_TRACKER_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file LD2410Tracker.h
+ */
+
+#include "LD2410Parser.h"
+
+/**
+ * @brief A fixed-point alpha-beta tracker of the target distance.
+ *
+ * Feed it every decoded frame: it smooths the distance, estimates the radial velocity,
+ * and reports when the target appears, approaches, recedes, lingers or is lost.
+ * The time step is taken from the frame timestamps, so dropped frames and irregular
+ * frame spacing are handled naturally.
+ */
+class LD2410Tracker
+{
+public:
+  enum Source
+  {
+    DETECTED = 0, // SensorData::distance
+    MOVING,       // SensorData::mTargetDistance, while a moving target is reported
+    STATIONARY    // SensorData::sTargetDistance, while a stationary target is reported
+  };
+  enum Event
+  {
+    NONE = 0,
+    APPEAR,   // a new track was started
+    APPROACH, // the target moves towards the sensor faster than approachSpeed
+    RECEDE,   // the target moves away from the sensor faster than approachSpeed
+    LINGER,   // the target has stayed slower than lingerSpeed for lingerTime
+    LOST      // no measurement for lostTime
+  };
+  typedef void (*TrackerCallback)(Event event, const LD2410Tracker &tracker, void *context);
+
+  /**
+   * @brief Construct a new LD2410Tracker object
+   *
+   * @param source - which distance of the frame to track
+   * @param alpha - the position gain [1/256], higher follows the measurements more closely
+   * @param beta - the velocity gain [1/256]
+   */
+  LD2410Tracker(Source source = DETECTED, byte alpha = 96, byte beta = 16);
+
+  /**
+   * @brief Set the event thresholds
+   *
+   * @param approachSpeed - speed [cm/s] above which APPROACH/RECEDE are reported
+   * @param lingerSpeed - speed [cm/s] below which the target is lingering
+   * @param lingerTime - time [ms] below lingerSpeed before LINGER is reported
+   * @param lostTime - time [ms] without a measurement before LOST is reported
+   */
+  void setThresholds(unsigned int approachSpeed, unsigned int lingerSpeed,
+                     unsigned long lingerTime, unsigned long lostTime);
+
+  /**
+   * @brief Call the callback on every event
+   */
+  void onEvent(TrackerCallback callback, void *context = nullptr);
+
+  /**
+   * @brief Feed a decoded frame
+   *
+   * @return Event - the event raised by this frame, or NONE
+   */
+  Event update(const LD2410Parser::SensorData &data);
+
+  /**
+   * @brief Check whether a target is being tracked
+   */
+  bool tracking() const;
+
+  /**
+   * @brief Get the smoothed distance [cm]
+   */
+  long distance() const;
+
+  /**
+   * @brief Get the radial velocity [cm/s]: negative when approaching, positive when receding
+   */
+  long velocity() const;
+
+  /**
+   * @brief Get the current motion state (APPROACH, RECEDE, LINGER), or NONE
+   */
+  Event state() const;
+
+  /**
+   * @brief Drop the current track
+   */
+  void reset();
+
+private:
+  Source src;
+  byte alpha, beta;
+  unsigned int approach = 20;
+  unsigned int linger = 8;
+  unsigned long lingerMs = 3000;
+  unsigned long lostMs = 1500;
+  TrackerCallback callback = nullptr;
+  void *context = nullptr;
+  bool active = false;
+  long x = 0; // distance [cm/16]
+  long v = 0; // velocity [(cm/s)/16]
+  unsigned long lastUs = 0;
+  unsigned long measuredUs = 0;
+  unsigned long slowSince = 0;
+  Event motion = NONE;
+  Event raise(Event event);
+  bool measure(const LD2410Parser::SensorData &data, unsigned long &z) const;
+};
+
+#endif // LD2410_TRACKER_H
@@ -1,5 +1,11 @@
 #include "MyLD2410.h"
 
+#ifndef LD2410_NO_STATISTICS
+#define LD2410_STAT(x) x
+#else
+#define LD2410_STAT(x)
+#endif
+
 /*** BEGIN LD2410 namespace ***/
 namespace LD2410
 {
@@ -11,32 +17,48 @@ namespace LD2410
       "Auto thresholds in progress",
       "Auto thresholds successful",
       "Auto thresholds failed"};
-  const byte headData[4]{0xF4, 0xF3, 0xF2, 0xF1};
-  const byte tailData[4]{0xF8, 0xF7, 0xF6, 0xF5};
-  const byte headConfig[4]{0xFD, 0xFC, 0xFB, 0xFA};
-  const byte tailConfig[4]{4, 3, 2, 1};
   const byte configEnable[6]{4, 0, 0xFF, 0, 1, 0};
   const byte configDisable[4]{2, 0, 0xFE, 0};
-  const byte MAC[6]{4, 0, 0xA5, 0, 1, 0};
   const byte firmware[4]{2, 0, 0xA0, 0};
   const byte res[4]{2, 0, 0xAB, 0};
   const byte resCoarse[6]{4, 0, 0xAA, 0, 0, 0};
   const byte resFine[6]{4, 0, 0xAA, 0, 1, 0};
-  const byte changeBaud[6]{4, 0, 0xA1, 0, 7, 0};
   const byte reset[4]{2, 0, 0xA2, 0};
   const byte reboot[4]{2, 0, 0xA3, 0};
-  const byte BTon[6]{4, 0, 0xA4, 0, 1, 0};
-  const byte BToff[6]{4, 0, 0xA4, 0, 0, 0};
-  const byte BTpasswd[10]{8, 0, 0xA9, 0, 0x48, 0x69, 0x4C, 0x69, 0x6E, 0x6B};
   const byte param[4]{2, 0, 0x61, 0};
   const byte engOn[4]{2, 0, 0x62, 0};
   const byte engOff[4]{2, 0, 0x63, 0};
+  byte gateParam[0x16]{0x14, 0, 0x64, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0};
+  byte maxGate[0x16]{0x14, 0, 0x60, 0, 0, 0, 8, 0, 0, 0, 1, 0, 8, 0, 0, 0, 2, 0, 5, 0, 0, 0};
+  const unsigned long frameTimeout = 100UL;
+  // wake up this much [us] (plus twice the jitter) before a frame is expected to be complete
+  const unsigned long wakeMargin = 500UL;
+#ifndef LD2410_NO_EARLY_DISPATCH
+  // payload bytes up to and including the detection distance
+  const byte earlyBytes = 11;
+#endif
+#ifndef LD2410_NO_BLUETOOTH
+  const byte MAC[6]{4, 0, 0xA5, 0, 1, 0};
+  const byte BTon[6]{4, 0, 0xA4, 0, 1, 0};
+  const byte BToff[6]{4, 0, 0xA4, 0, 0, 0};
+  const byte BTpasswd[10]{8, 0, 0xA9, 0, 0x48, 0x69, 0x4C, 0x69, 0x6E, 0x6B};
+#endif
+#if !defined(LD2410_NO_BAUD) || !defined(LD2410_NO_PROFILE)
+  const byte changeBaud[6]{4, 0, 0xA1, 0, 7, 0};
+#endif
+#ifndef LD2410_NO_AUX
   const byte auxQuery[4]{2, 0, 0xAE, 0};
   const byte auxConfig[8]{6, 0, 0xAD, 0, 0, 0x80, 0, 0};
+#endif
+#ifndef LD2410_NO_AUTO_THRESHOLDS
   const byte autoBegin[6]{4, 0, 0x0B, 0, 0x0A, 0};
   const byte autoQuery[4]{2, 0, 0x1B, 0};
-  byte gateParam[0x16]{0x14, 0, 0x64, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0};
-  byte maxGate[0x16]{0x14, 0, 0x60, 0, 0, 0, 8, 0, 0, 0, 1, 0, 8, 0, 0, 0, 2, 0, 5, 0, 0, 0};
+  const unsigned long ackTimeout = 2000UL;
+  const unsigned long autoPollInterval = 1000UL;
+#endif
+#ifndef LD2410_NO_ADAPTIVE
+  const unsigned long adaptiveDwell = 2000UL;
+#endif
 
   String byte2hex(byte b, bool addZero = true)
   {
@@ -46,6 +68,7 @@ namespace LD2410
       return "0" + bStr;
     return bStr;
   }
+#ifndef LD2410_NO_DEBUG
   void printBuf(const byte *buf, byte size)
   {
     for (byte i = 0; i < size; i++)
@@ -56,146 +79,268 @@ namespace LD2410
     Serial.println();
     Serial.flush();
   }
-  bool bufferEndsWith(const byte *buf, int iMax, const byte *other)
-  {
-    for (int j = 3; j >= 0; j--)
-    {
-      if (--iMax < 0)
-        iMax = 3;
-      if (buf[iMax] != other[j])
-        return false;
-    }
-    return true;
-  }
+#endif
 }
 /*** END LD2410 namespace ***/
 
 MyLD2410::Response MyLD2410::check()
 {
-  while (sensor->available())
-  {
-    headBuf[headBufI++] = byte(sensor->read());
-    headBufI %= 4;
-    if (LD2410::bufferEndsWith(headBuf, headBufI, LD2410::headConfig) && processAck())
-      return ACK;
-    if (LD2410::bufferEndsWith(headBuf, headBufI, LD2410::headData) && processData())
-      return DATA;
-  }
-  return FAIL;
+  return drain(*sensor);
 }
 
-bool MyLD2410::sendCommand(const byte *command)
+MyLD2410::Response MyLD2410::feed(const byte *data, size_t size)
 {
-  byte size = command[0] + 2;
-  // LD2410::printBuf(command, size);
-  sensor->write(LD2410::headConfig, 4);
-  sensor->write(command, size);
-  sensor->write(LD2410::tailConfig, 4);
-  sensor->flush();
-  unsigned long giveUp = millis() + 2000UL;
-  while (millis() < giveUp)
+  Response response = FAIL;
+  unsigned long frames = 0;
+  if (beginCheck(response, frames, false))
+    return response;
+  // the chunk is not kept: consume all of it, even without coalescing
+  for (size_t i = 0; i < size; i++)
   {
-    while (sensor->available())
-    {
-      headBuf[headBufI++] = byte(sensor->read());
-      headBufI %= 4;
-      if (LD2410::bufferEndsWith(headBuf, headBufI, LD2410::headConfig))
-        return processAck();
-    }
+    Response r = process(data[i], int(size - i - 1));
+    if (r == DATA)
+      frames++;
+    if (r > response)
+      response = r;
+  }
+  return finishCheck(response, frames, false);
+}
+
+bool MyLD2410::beginCheck(Response &response, unsigned long &frames, bool jobs)
+{
+  frames = pendingFrames;
+  checkTimeout();
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  if (jobs && (calStep != CAL_IDLE))
+    calibrationStep();
+#else
+  (void)jobs;
+#endif
+  skippedFrames = 0;
+  if (pendingFrames)
+  { // frames decoded while waiting for a reply
+    pendingFrames = 0;
+    response = DATA;
+    if (!coalesce)
+      return true;
   }
   return false;
 }
 
-bool MyLD2410::readFrame()
+MyLD2410::Response MyLD2410::finishCheck(Response response, unsigned long frames, bool jobs)
 {
-  int frameSize = -1, bytes = 2;
-  inBufI = 0;
-  unsigned long frameTimeout = millis() + 100;
-  while (bytes) // read two bytes for frame size
-  {
+  if (frames > 1)
+    skippedFrames = frames - 1;
+#ifndef LD2410_NO_ADAPTIVE
+  if (jobs && (response == DATA) && adaptive)
+    adaptiveUpdate();
+#else
+  (void)jobs;
+#endif
+  return response;
+}
 
-    if (sensor->available())
-    {
-      inBuf[inBufI++] = byte(sensor->read());
-      bytes--;
-    }
-    else if (millis() > frameTimeout)
-      return false; // timeout
+LD2410Parser::Event MyLD2410::receive(byte b, int buffered)
+{
+  bool idle = parser.idle();
+  LD2410Parser::Event event = parser.push(b);
+  if (idle && !parser.idle())
+  { // first header byte: the bytes still buffered arrived after it
+    if (buffered < 0)
+      buffered = sensor->available();
+    frameStartMicros = micros() - (unsigned long)buffered * byteMicros;
+    frameStart = millis();
   }
+#ifndef LD2410_NO_EARLY_DISPATCH
+  if (earlyCallback)
+    earlyDispatch(event);
+#endif
+  return event;
+}
 
-  frameSize = (inBuf[0]) | (inBuf[1] << 8);
+#ifndef LD2410_NO_EARLY_DISPATCH
+void MyLD2410::earlyDispatch(LD2410Parser::Event event)
+{
+  if (earlyPending)
+  { // a valid frame is committed by processData()
+    if ((event != LD2410Parser::DATA) && !parser.receivingData())
+      earlyFinish(ROLLBACK);
+    return;
+  }
+  if (!parser.receivingData() || (parser.received() != LD2410::earlyBytes))
+    return;
+  const byte *p = parser.partial();
+  if (!(((p[0] == 1) || (p[0] == 2)) && (p[1] == 0xAA)))
+    return;
+  earlyData.status = p[2] & 7;
+  earlyData.mTargetDistance = p[3] | (p[4] << 8);
+  earlyData.mTargetSignal = p[5];
+  earlyData.sTargetDistance = p[6] | (p[7] << 8);
+  earlyData.sTargetSignal = p[8];
+  earlyData.distance = p[9] | (p[10] << 8);
+  earlyData.mTargetSignals.setN(0);
+  earlyData.sTargetSignals.setN(0);
+  earlyData.lightLevel = 0;
+  earlyData.outLevel = 0;
+  earlyData.timestamp = millis();
+  earlyData.timestampUs = frameStartMicros;
+  earlyData.missedFrames = 0;
+  earlyPending = true;
+  earlyCallback(EARLY, earlyData, earlyContext);
+}
+
+void MyLD2410::earlyFinish(EarlyPhase phase)
+{
+  if (!earlyPending)
+    return;
+  earlyPending = false;
+  if (earlyCallback)
+    earlyCallback(phase, (phase == COMMIT) ? sData : earlyData, earlyContext);
+}
+#endif
+
+MyLD2410::Response MyLD2410::process(byte b, int buffered)
+{
+  LD2410Parser::Event event = receive(b, buffered);
+  if ((event == LD2410Parser::ACK) && processAck())
+    return ACK;
+  if ((event == LD2410Parser::DATA) && processData())
+    return DATA;
+  return FAIL;
+}
 
-  if (frameSize <= 0)
-    return false; // Corrupted frame received
-  frameSize += 4;
-  if (frameSize > LD2410_BUFFER_SIZE)
-    return false; // Frame too large, discard
+void MyLD2410::checkTimeout()
+{
+  if (!parser.idle() && (millis() - frameStart > LD2410::frameTimeout))
+  { // the rest of the frame never arrived
+    parser.reset();
+    LD2410_STAT(stats.timeouts++);
+#ifndef LD2410_NO_EARLY_DISPATCH
+    earlyFinish(ROLLBACK);
+#endif
+  }
+}
 
-  inBufI = 0;
-  frameTimeout = millis() + 100;
-  while (frameSize > 0) // read the rest of the frame
+void MyLD2410::writeCommand(const byte *command)
+{
+  byte size = command[0] + 2;
+  // LD2410::printBuf(command, size);
+  sensor->write(LD2410Parser::headConfig, 4);
+  sensor->write(command, size);
+  sensor->write(LD2410Parser::tailConfig, 4);
+  sensor->flush();
+}
+
+bool MyLD2410::sendCommand(const byte *command)
+{
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  if (calStep != CAL_IDLE)
+    return false; // the config session belongs to the auto-thresholds job
+#endif
+#ifndef LD2410_NO_TRACE
+  unsigned long t0 = micros();
+#endif
+  writeCommand(command);
+  bool replied = false;
+  bool success = false;
+  unsigned long giveUp = millis() + 2000UL;
+  while (!replied && (millis() < giveUp))
   {
-    if (sensor->available())
+    checkTimeout();
+    while (sensor->available())
     {
-      inBuf[inBufI++] = byte(sensor->read());
-      frameSize--;
+      LD2410Parser::Event event = receive(byte(sensor->read()));
+      if (event == LD2410Parser::ACK)
+      {
+        success = processAck();
+        replied = true;
+        break;
+      }
+      if ((event == LD2410Parser::DATA) && processData())
+        pendingFrames++;
     }
-    else if (millis() > frameTimeout)
-      return false; // timeout
   }
-  return true;
+#ifndef LD2410_NO_TRACE
+  if (trace)
+    trace->record(LD2410Trace::COMMAND, t0, micros() - t0, command[2] | (command[3] << 8),
+                  replied ? (success ? LD2410Trace::OK : LD2410Trace::FAILED) : LD2410Trace::TIMEOUT);
+#endif
+  return success;
 }
 
 bool MyLD2410::processAck()
 {
-  if (!readFrame())
-    return false;
+  const byte *inBuf = parser.frame();
+#ifndef LD2410_NO_DEBUG
   if (_debug)
-    LD2410::printBuf(inBuf, inBufI);
-  if (!LD2410::bufferEndsWith(inBuf, inBufI, LD2410::tailConfig))
-    return false;
+    LD2410::printBuf(inBuf, parser.frameSize());
+#endif
+  LD2410_STAT(unsigned long t0 = micros());
+  lastReply = millis();
   unsigned long command = inBuf[0] | (inBuf[1] << 8);
   if (inBuf[2] | (inBuf[3] << 8))
+  {
+    LD2410_STAT(stats.ackErrors++);
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+    if (calStep != CAL_IDLE)
+      calibrationAck(command, false);
+#endif
     return false;
+  }
   switch (command)
   {
   case 0x1FF: // entered config mode
+    if (!inGap)
+    {
+      lastGap.start = sData.timestamp;
+      inGap = true;
+    }
+#ifndef LD2410_NO_TRACE
+    if (!isConfig)
+      configStartUs = micros();
+#endif
     isConfig = true;
     version = inBuf[4] | (inBuf[5] << 8);
     bufferSize = inBuf[6] | (inBuf[7] << 8);
     break;
   case 0x1FE: // exited config mode
+#ifndef LD2410_NO_TRACE
+    traceConfig();
+#endif
     isConfig = false;
     break;
+#ifndef LD2410_NO_BLUETOOTH
   case 0x1A5: // MAC
     for (int i = 0; i < 6; i++)
       MAC[i] = inBuf[i + 4];
-    MACstr = LD2410::byte2hex(MAC[0]);
-    for (int i = 1; i < 6; i++)
-      MACstr += ":" + LD2410::byte2hex(MAC[i]);
+    hasMAC = true;
     break;
+#endif
   case 0x1A0: // Firmware
-    firmware = LD2410::byte2hex(inBuf[7], false);
-    firmware += "." + LD2410::byte2hex(inBuf[6]);
-    firmware += "." + LD2410::byte2hex(inBuf[11]);
-    firmware += LD2410::byte2hex(inBuf[10]);
-    firmware += LD2410::byte2hex(inBuf[9]);
-    firmware += LD2410::byte2hex(inBuf[8]);
     firmwareMajor = inBuf[7];
     firmwareMinor = inBuf[6];
+    for (int i = 0; i < 4; i++)
+      firmwareBuild[i] = inBuf[11 - i];
     break;
   case 0x1AB: // Query Resolution
     fineRes = (inBuf[4]);
     break;
+#ifndef LD2410_NO_AUX
   case 0x1AE: // Query auxiliary control parameters
     lightControl = LightControl(inBuf[4]);
     lightThreshold = inBuf[5];
     outputControl = OutputControl(inBuf[6]);
     break;
+#endif
+#ifndef LD2410_NO_AUTO_THRESHOLDS
   case 0x11B:
     autoStatus = AutoStatus(inBuf[4]);
     break;
+#endif
   case 0x1A3: // Reboot
+#ifndef LD2410_NO_TRACE
+    traceConfig();
+#endif
     isEnhanced = false;
     isConfig = false;
     break;
@@ -203,10 +348,11 @@ bool MyLD2410::processAck()
     maxRange = inBuf[5];
     movingThresholds.setN(inBuf[6]);
     stationaryThresholds.setN(inBuf[7]);
-    for (byte i = 0; i <= movingThresholds.N; i++)
+    for (byte i = 0; i < 9; i++)
+    { // keep all gates, including those beyond the maximum gate
       movingThresholds.values[i] = inBuf[8 + i];
-    for (byte i = 0; i <= stationaryThresholds.N; i++)
       stationaryThresholds.values[i] = inBuf[17 + i];
+    }
     noOne_window = inBuf[26] | (inBuf[27] << 8);
     break;
   case 0x162:
@@ -219,14 +365,18 @@ bool MyLD2410::processAck()
     if (LD2410::gateParam[7] == 0xFF)
       LD2410::gateParam[7] = 0;
   }
+  LD2410_STAT(stats.ackFrames++; stats.parseTime.add(micros() - t0));
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  if (calStep != CAL_IDLE)
+    calibrationAck(command, true);
+#endif
   return (true);
 }
 
 bool MyLD2410::processData()
 {
-  if (!readFrame())
-    return false;
   unsigned long now = millis();
+#ifndef LD2410_NO_DEBUG
   if (_debug)
   {
     Serial.print('#');
@@ -234,47 +384,130 @@ bool MyLD2410::processData()
     Serial.print(" [");
     Serial.print(now);
     Serial.print("ms] : ");
-    LD2410::printBuf(inBuf, inBufI);
+    LD2410::printBuf(parser.frame(), parser.frameSize());
   }
-  if (!LD2410::bufferEndsWith(inBuf, inBufI, LD2410::tailData))
+#endif
+#if !defined(LD2410_NO_STATISTICS) || !defined(LD2410_NO_ADAPTIVE)
+  unsigned long t0 = micros();
+#endif
+  unsigned long previous = sData.timestampUs;
+  if (!parser.decode(sData))
+  {
+#ifndef LD2410_NO_EARLY_DISPATCH
+    earlyFinish(ROLLBACK);
+#endif
     return false;
-  if (((inBuf[0] == 1) || (inBuf[0] == 2)) && (inBuf[1] == 0xAA))
-  { // Basic mode and Enhanced
-    ++dataFrames;
-    sData.timestamp = now;
-    sData.status = inBuf[2] & 7;
-    sData.mTargetDistance = inBuf[3] | (inBuf[4] << 8);
-    sData.mTargetSignal = inBuf[5];
-    sData.sTargetDistance = inBuf[6] | (inBuf[7] << 8);
-    sData.sTargetSignal = inBuf[8];
-    sData.distance = inBuf[9] | (inBuf[10] << 8);
-    if (inBuf[0] == 1)
-    { // Enhanced mode only
-      isEnhanced = true;
-      sData.mTargetSignals.setN(inBuf[11]);
-      sData.sTargetSignals.setN(inBuf[12]);
-      byte *p = inBuf + 13;
-      for (byte i = 0; i <= sData.mTargetSignals.N; i++)
-        sData.mTargetSignals.values[i] = *(p++);
-      for (byte i = 0; i <= sData.sTargetSignals.N; i++)
-        sData.sTargetSignals.values[i] = *(p++);
-      lightLevel = *(p++);
-      outLevel = *p;
-    }
-    else
-    { // Basic mode only
-      isEnhanced = false;
-      sData.mTargetSignals.setN(0);
-      sData.sTargetSignals.setN(0);
-      lightLevel = 0;
-      outLevel = 0;
-    }
   }
-  else
-    return false;
+  sData.timestampUs = frameStartMicros;
+  sData.missedFrames = 0;
+  if (dataFrames && !inGap)
+    recoverClock(frameStartMicros - previous);
+  if (inGap && !isConfig)
+    closeGap(now);
+  ++dataFrames;
+  sData.timestamp = now;
+  isEnhanced = (parser.frame()[0] == 1);
+#ifndef LD2410_NO_STATISTICS
+  stats.dataFrames++;
+  if (stats.dataFrames > 1)
+    stats.frameInterval.add(frameStartMicros - previous);
+  stats.parseTime.add(micros() - t0);
+  stats.frameLatency.add(micros() - frameStartMicros);
+#endif
+#ifndef LD2410_NO_ADAPTIVE
+  if (adaptive)
+    adaptiveAccount(micros() - t0);
+#endif
+#ifndef LD2410_NO_TRACE
+  if (trace)
+    trace->record(LD2410Trace::FRAME, frameStartMicros, micros() - frameStartMicros, sData.status, isEnhanced);
+#endif
+#ifndef LD2410_NO_EARLY_DISPATCH
+  earlyFinish(COMMIT);
+#endif
+  if (dataCallback)
+    dataCallback(sData, dataContext);
   return true;
 }
 
+void MyLD2410::recoverClock(unsigned long interval)
+{
+  if (!framePeriod)
+  { // first estimate: accept anything that looks like a single period
+    if ((interval > 20000UL) && (interval < 1000000UL))
+      framePeriod = interval;
+    return;
+  }
+  // the number of sensor periods covered by the interval; more than one means lost frames
+  unsigned long k = (interval + framePeriod / 2) / framePeriod;
+  if (!k)
+    k = 1;
+  if (k > 0xFF)
+    return; // too long to tell, do not disturb the estimate
+  sData.missedFrames = k - 1;
+  long error = long(interval / k) - long(framePeriod);
+  if (k <= 4)
+    framePeriod += error / 16;
+  long deviation = long(interval) - long(k * framePeriod);
+  if (deviation < 0)
+    deviation = -deviation;
+  frameJitter += (deviation - long(frameJitter)) / 16;
+}
+
+void MyLD2410::closeGap(unsigned long now)
+{
+  inGap = false;
+  lastGap.end = now;
+  lastGap.frames = 0;
+  unsigned long period = (framePeriod + 500) / 1000;
+  if (dataFrames && period)
+  {
+    unsigned long frames = ((now - lastGap.start) + period / 2) / period;
+    lastGap.frames = (frames) ? frames - 1 : 0;
+  }
+  suppressedFrames += lastGap.frames;
+}
+
+#ifndef LD2410_NO_ADAPTIVE
+void MyLD2410::adaptiveAccount(unsigned long decodeTime)
+{
+  byte frameSize = parser.frameSize() + 6; // header and length field are not in the frame
+  if (isEnhanced)
+  {
+    savings.enhancedFrames++;
+    enhancedFrameSize = frameSize;
+    enhancedDecode8 += decodeTime - (enhancedDecode8 >> 3);
+  }
+  else
+  {
+    savings.basicFrames++;
+    basicDecode8 += decodeTime - (basicDecode8 >> 3);
+    if (enhancedFrameSize > frameSize)
+      savings.bytesSaved += enhancedFrameSize - frameSize;
+    if (enhancedDecode8 > basicDecode8)
+      savings.microsSaved += (enhancedDecode8 - basicDecode8) >> 3;
+  }
+}
+
+void MyLD2410::adaptiveUpdate()
+{
+  unsigned long now = millis();
+  bool present = (sData.status) && (sData.status < 4);
+  if (present)
+    lastPresence = now;
+  if (isConfig || (lastSwitch && (now - lastSwitch < LD2410::adaptiveDwell)))
+    return;
+  bool wantEnhanced = present || gateSubscribers || (lastPresence && (now - lastPresence < basicHold));
+  if (wantEnhanced == isEnhanced)
+    return;
+  lastSwitch = now;
+  if (enhancedMode(wantEnhanced))
+    savings.switches++;
+  else
+    resync(true); // a lost reply may leave the sensor in config mode, with the data stream stopped
+}
+#endif
+
 /**
 @brief Construct from a serial stream object
 */
@@ -309,6 +542,64 @@ void MyLD2410::end()
   isEnhanced = false;
 }
 
+bool MyLD2410::resync(bool exitConfig)
+{
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  if ((calStep != CAL_IDLE) && (calStep != CAL_WAIT))
+    return false; // the flush could drop the reply the auto-thresholds job is waiting for
+#endif
+  while (sensor->available())
+    sensor->read();
+  parser.reset();
+#ifndef LD2410_NO_EARLY_DISPATCH
+  earlyFinish(ROLLBACK);
+#endif
+  if (!exitConfig)
+    return true;
+  // still in config mode until the reply, which closes the traced config span
+  bool success = sendCommand(LD2410::configDisable);
+  if (success)
+    isConfig = false;
+  return success;
+}
+
+#ifndef LD2410_NO_ADAPTIVE
+void MyLD2410::adaptiveMode(bool enable, unsigned long basic_hold)
+{
+  adaptive = enable;
+  basicHold = basic_hold;
+  lastSwitch = 0;
+}
+
+bool MyLD2410::inAdaptiveMode()
+{
+  return adaptive;
+}
+
+void MyLD2410::subscribeGateData(bool subscribe)
+{
+  if (subscribe && (gateSubscribers < 0xFF))
+    gateSubscribers++;
+  else if (!subscribe && gateSubscribers)
+    gateSubscribers--;
+}
+
+MyLD2410::AdaptiveSavings MyLD2410::getAdaptiveSavings()
+{
+  return savings;
+}
+#endif
+
+void MyLD2410::coalesceFrames(bool enable)
+{
+  coalesce = enable;
+}
+
+unsigned long MyLD2410::getSkippedFrames()
+{
+  return skippedFrames;
+}
+
 void MyLD2410::debugOn()
 {
   _debug = true;
@@ -354,6 +645,136 @@ unsigned long MyLD2410::getFrameCount()
   return dataFrames;
 }
 
+unsigned long MyLD2410::getTimestampMicros()
+{
+  return sData.timestampUs;
+}
+
+unsigned long MyLD2410::getFrameAge()
+{
+  return micros() - sData.timestampUs;
+}
+
+unsigned long MyLD2410::getFramePeriod()
+{
+  return framePeriod;
+}
+
+unsigned long MyLD2410::getFrameJitter()
+{
+  return frameJitter;
+}
+
+unsigned long MyLD2410::frameDuration()
+{
+  // header + length + payload + tail
+  return (isEnhanced ? 45UL : 23UL) * byteMicros;
+}
+
+unsigned long MyLD2410::wakeGuard()
+{
+  return 2 * frameJitter + LD2410::wakeMargin;
+}
+
+unsigned long MyLD2410::nextFrameExpectedAt()
+{
+  if (!framePeriod || !dataFrames)
+    return 0;
+  unsigned long elapsed = micros() - sData.timestampUs;
+  unsigned long late = frameDuration() + wakeGuard();
+  unsigned long k = (elapsed > late) ? (elapsed - late) / framePeriod + 1 : 1;
+  return sData.timestampUs + k * framePeriod;
+}
+
+unsigned long MyLD2410::idleHint()
+{
+  if (!framePeriod || !dataFrames || isConfig || pendingFrames || !parser.idle() || sensor->available())
+    return 0;
+  long wait = long(nextFrameExpectedAt() + frameDuration() - wakeGuard() - micros());
+  return (wait > 0) ? (unsigned long)wait : 0;
+}
+
+bool MyLD2410::waitForNextFrame(unsigned long maxWait)
+{
+  unsigned long wait = idleHint();
+  if (wait > maxWait)
+    wait = maxWait;
+  if (wait < 1000)
+    return false;
+  delay(wait / 1000);
+  return true;
+}
+
+void MyLD2410::setBaudRate(unsigned long baud)
+{
+  if (baud)
+    byteMicros = 10000000UL / baud;
+}
+
+unsigned long MyLD2410::getSuppressedFrames()
+{
+  return suppressedFrames;
+}
+
+const MyLD2410::ConfigGap &MyLD2410::getLastConfigGap()
+{
+  return lastGap;
+}
+
+unsigned long MyLD2410::getLastReplyTime()
+{
+  return lastReply;
+}
+
+void MyLD2410::onData(DataCallback callback, void *context)
+{
+  dataCallback = callback;
+  dataContext = context;
+}
+
+#ifndef LD2410_NO_EARLY_DISPATCH
+void MyLD2410::onEarlyData(EarlyCallback callback, void *context)
+{
+  if (!callback)
+    earlyPending = false;
+  earlyCallback = callback;
+  earlyContext = context;
+}
+#endif
+
+#ifndef LD2410_NO_TRACE
+void MyLD2410::setTrace(LD2410Trace *trace)
+{
+  this->trace = trace;
+}
+
+void MyLD2410::traceConfig()
+{
+  if (trace && isConfig)
+    trace->record(LD2410Trace::CONFIG, configStartUs, micros() - configStartUs);
+}
+#endif
+
+#ifndef LD2410_NO_STATISTICS
+MyLD2410::Statistics MyLD2410::getStatistics()
+{
+  Statistics snapshot = stats;
+  const LD2410Parser::Counters &counters = parser.getCounters();
+  snapshot.bytesRead = counters.bytes;
+  snapshot.bytesDiscarded = counters.discarded;
+  snapshot.tailErrors = counters.tailErrors;
+  snapshot.lengthErrors = counters.lengthErrors;
+  snapshot.malformedFrames = counters.malformedFrames;
+  return snapshot;
+}
+
+void MyLD2410::resetStatistics()
+{
+  stats = Statistics();
+  parser.resetCounters();
+}
+#endif
+
 bool MyLD2410::isDataValid()
 {
   return (millis() < sData.timestamp + 500UL);
@@ -409,24 +830,38 @@ unsigned long MyLD2410::detectedDistance()
   return sData.distance;
 }
 
+#ifndef LD2410_NO_BLUETOOTH
 const byte *MyLD2410::getMAC()
 {
-  if (MACstr.length() == 0)
+  if (!hasMAC)
     requestMAC();
   return MAC;
 }
 
 String MyLD2410::getMACstr()
 {
-  if (MACstr.length() == 0)
+  if (!hasMAC)
     requestMAC();
+  if (!hasMAC)
+    return "";
+  String MACstr = LD2410::byte2hex(MAC[0]);
+  for (int i = 1; i < 6; i++)
+    MACstr += ":" + LD2410::byte2hex(MAC[i]);
   return MACstr;
 }
+#endif
 
 String MyLD2410::getFirmware()
 {
-  if (firmware.length() == 0)
+  if (!firmwareMajor)
     requestFirmware();
+  if (!firmwareMajor)
+    return "";
+  String firmware = LD2410::byte2hex(firmwareMajor, false);
+  firmware += "." + LD2410::byte2hex(firmwareMinor);
+  firmware += ".";
+  for (int i = 0; i < 4; i++)
+    firmware += LD2410::byte2hex(firmwareBuild[i]);
   return firmware;
 }
 
@@ -444,6 +879,16 @@ byte MyLD2410::getFirmwareMinor()
   return firmwareMinor;
 }
 
+unsigned long MyLD2410::getFirmwareBuild()
+{
+  if (!firmwareMajor)
+    requestFirmware();
+  unsigned long build = 0;
+  for (int i = 0; i < 4; i++)
+    build = (build << 8) | firmwareBuild[i];
+  return build;
+}
+
 unsigned long MyLD2410::getVersion()
 {
   if (version == 0)
@@ -509,13 +954,16 @@ bool MyLD2410::enhancedMode(bool enable)
     return configMode() && sendCommand(((enable) ? LD2410::engOn : LD2410::engOff)) && configMode(false);
 }
 
+#ifndef LD2410_NO_AUX
 bool MyLD2410::requestAuxConfig()
 {
   if (isConfig)
     return sendCommand(LD2410::auxQuery);
   return configMode() && sendCommand(LD2410::auxQuery) && configMode(false);
 }
+#endif
 
+#ifndef LD2410_NO_AUTO_THRESHOLDS
 bool MyLD2410::autoThresholds(byte _timeout)
 {
   byte cmd[6];
@@ -539,12 +987,132 @@ AutoStatus MyLD2410::getAutoStatus()
   return AutoStatus::NOT_SET;
 }
 
+bool MyLD2410::startAutoThresholds(byte _timeout, AutoThresholdsCallback progress, AutoThresholdsCallback done, void *context)
+{
+  if (calStep != CAL_IDLE)
+    return false;
+  memcpy(calCommand, LD2410::autoBegin, 6);
+  if (_timeout)
+    calCommand[4] = _timeout;
+  calProgress = progress;
+  calDone = done;
+  calContext = context;
+  calResult = AutoStatus::NOT_SET;
+  calStart = millis();
+  calKeepConfig = isConfig;
+  if (isConfig)
+    calibrationSend(CAL_START, calCommand);
+  else
+    calibrationSend(CAL_CONFIG, LD2410::configEnable);
+  return true;
+}
+
+bool MyLD2410::autoThresholdsRunning()
+{
+  return calStep != CAL_IDLE;
+}
+
+void MyLD2410::calibrationSend(byte step, const byte *command)
+{
+  calStep = step;
+  calSent = millis();
+  writeCommand(command);
+}
+
+void MyLD2410::calibrationStep()
+{
+  unsigned long now = millis();
+  if (calStep == CAL_WAIT)
+  {
+    if (now - calSent >= calWait)
+      calibrationSend(CAL_QUERY, LD2410::autoQuery);
+  }
+  else if (now - calSent > LD2410::ackTimeout)
+    calibrationAck(0, false); // the reply never came
+}
+
+void MyLD2410::calibrationAck(unsigned long command, bool ok)
+{
+  if (!ok)
+  {
+    calResult = AutoStatus::NOT_SET;
+    if (calStep == CAL_EXIT)
+      calibrationDone();
+    else
+      calibrationExit();
+    return;
+  }
+  switch (calStep)
+  {
+  case CAL_CONFIG:
+    if (command == 0x1FF)
+      calibrationSend(CAL_START, calCommand);
+    break;
+  case CAL_START:
+    if (command == 0x10B)
+    { // allow for leaving the room before the first poll
+      calStep = CAL_WAIT;
+      calSent = millis();
+      calWait = calCommand[4] * 1000UL + LD2410::autoPollInterval;
+    }
+    break;
+  case CAL_QUERY:
+    if (command != 0x11B)
+      break;
+    if (autoStatus == AutoStatus::IN_PROGRESS)
+    {
+      if (calProgress)
+        calProgress(autoStatus, millis() - calStart, calContext);
+      calStep = CAL_WAIT;
+      calSent = millis();
+      calWait = LD2410::autoPollInterval;
+    }
+    else if (autoStatus == AutoStatus::COMPLETED)
+      calibrationSend(CAL_PARAM, LD2410::param); // read back the new thresholds
+    else
+    {
+      calResult = autoStatus;
+      calibrationExit();
+    }
+    break;
+  case CAL_PARAM:
+    if (command == 0x161)
+    {
+      calResult = AutoStatus::COMPLETED;
+      calibrationExit();
+    }
+    break;
+  case CAL_EXIT:
+    if (command == 0x1FE)
+      calibrationDone();
+    break;
+  }
+}
+
+void MyLD2410::calibrationExit()
+{
+  if (calKeepConfig)
+    calibrationDone(); // the config session belongs to the sketch
+  else
+    calibrationSend(CAL_EXIT, LD2410::configDisable);
+}
+
+void MyLD2410::calibrationDone()
+{
+  calStep = CAL_IDLE;
+  if (calDone)
+    calDone(calResult, millis() - calStart, calContext);
+}
+#endif
+
+#ifndef LD2410_NO_BLUETOOTH
 bool MyLD2410::requestMAC()
 {
   if (isConfig)
     return sendCommand(LD2410::MAC);
   return configMode() && sendCommand(LD2410::MAC) && configMode(false);
 }
+#endif
 
 bool MyLD2410::requestFirmware()
 {
@@ -560,12 +1128,14 @@ bool MyLD2410::requestResolution()
   return configMode() && sendCommand(LD2410::res) && configMode(false);
 }
 
+#ifndef LD2410_NO_SETTERS
 bool MyLD2410::setResolution(bool fine)
 {
   if (isConfig && sendCommand(((fine) ? LD2410::resFine : LD2410::resCoarse)))
     return sendCommand(LD2410::res);
   return configMode() && sendCommand(((fine) ? LD2410::resFine : LD2410::resCoarse)) && sendCommand(LD2410::res) && configMode(false);
 }
+#endif
 
 bool MyLD2410::requestParameters()
 {
@@ -574,6 +1144,7 @@ bool MyLD2410::requestParameters()
   return configMode() && sendCommand(LD2410::param) && configMode(false);
 }
 
+#ifndef LD2410_NO_SETTERS
 bool MyLD2410::setGateParameters(byte gate, byte movingThreshold, byte stationaryThreshold)
 {
   if (movingThreshold > 100)
@@ -648,7 +1219,14 @@ bool MyLD2410::setGateParameters(
         success = false;
         break;
       }
+#ifndef LD2410_NO_TRACE
+      unsigned long t0 = micros();
+#endif
       delay(20);
+#ifndef LD2410_NO_TRACE
+      if (trace)
+        trace->record(LD2410Trace::WAIT, t0, micros() - t0, 20);
+#endif
     }
   }
   return success && setMaxGate(moving_thresholds.N, stationary_thresholds.N, noOneWindow) && configMode(false);
@@ -688,6 +1266,7 @@ bool MyLD2410::setMaxStationaryGate(byte stationaryGate)
     stationaryGate = 8;
   return setMaxGate(movingThresholds.N, stationaryGate, noOne_window);
 }
+#endif
 
 byte MyLD2410::getMaxMovingGate()
 {
@@ -703,12 +1282,14 @@ byte MyLD2410::getMaxStationaryGate()
   return stationaryThresholds.N;
 }
 
+#ifndef LD2410_NO_SETTERS
 bool MyLD2410::requestReset()
 {
   if (isConfig)
     return sendCommand(LD2410::reset) && sendCommand(LD2410::param) && sendCommand(LD2410::res);
   return configMode() && sendCommand(LD2410::reset) && sendCommand(LD2410::param) && sendCommand(LD2410::res) && configMode(false);
 }
+#endif
 
 bool MyLD2410::requestReboot()
 {
@@ -717,6 +1298,7 @@ bool MyLD2410::requestReboot()
   return configMode() && sendCommand(LD2410::reboot);
 }
 
+#ifndef LD2410_NO_BLUETOOTH
 bool MyLD2410::requestBTon()
 {
   if (isConfig)
@@ -760,7 +1342,9 @@ bool MyLD2410::resetBTpassword()
     return sendCommand(LD2410::BTpasswd);
   return configMode() && sendCommand(LD2410::BTpasswd) && configMode(false);
 }
+#endif
 
+#ifndef LD2410_NO_BAUD
 bool MyLD2410::setBaud(byte baud)
 {
   if ((baud < 1) || (baud > 8))
@@ -772,6 +1356,181 @@ bool MyLD2410::setBaud(byte baud)
     return sendCommand(cmd) && requestReboot();
   return configMode() && sendCommand(cmd) && requestReboot();
 }
+#endif
+
+#ifndef LD2410_NO_PROFILE
+bool MyLD2410::readProfile(DeviceProfile &profile)
+{
+  bool wasConfig = isConfig;
+  if (!(configMode() || isConfig))
+    return false;
+  bool success = sendCommand(LD2410::param) && sendCommand(LD2410::res);
+  if (success)
+  {
+    memcpy(profile.movingThresholds.values, movingThresholds.values, 9);
+    memcpy(profile.stationaryThresholds.values, stationaryThresholds.values, 9);
+    profile.movingThresholds.N = movingThresholds.N;
+    profile.stationaryThresholds.N = stationaryThresholds.N;
+    profile.maxMovingGate = movingThresholds.N;
+    profile.maxStationaryGate = stationaryThresholds.N;
+    profile.noOneWindow = noOne_window;
+    profile.resolution = fineRes;
+    profile.lightControl = LightControl::NOT_SET;
+    profile.outputControl = OutputControl::NOT_SET;
+#ifndef LD2410_NO_AUX
+    // firmware < 2.44 has no auxiliary control
+    if (sendCommand(LD2410::auxQuery))
+    {
+      profile.lightControl = lightControl;
+      profile.lightThreshold = lightThreshold;
+      profile.outputControl = outputControl;
+    }
+#endif
+    profile.baud = 0;
+    profile.bluetooth = -1;
+  }
+  if (!wasConfig)
+    configMode(false);
+  return success;
+}
+
+bool MyLD2410::applyProfile(const DeviceProfile &profile, byte *sent)
+{
+  byte commands = 0;
+  bool reboot = false;
+  bool wasConfig = isConfig;
+  if (sent)
+    *sent = 0;
+  if (!(configMode() || isConfig))
+    return false;
+  // read the current state once
+  bool success = sendCommand(LD2410::param);
+  if (success && (profile.resolution >= 0))
+    success = sendCommand(LD2410::res);
+#ifndef LD2410_NO_AUX
+  bool aux = (profile.lightControl != LightControl::NOT_SET) || (profile.outputControl != OutputControl::NOT_SET);
+  if (success && aux)
+    success = sendCommand(LD2410::auxQuery);
+#endif
+
+  // send only what differs
+  for (byte i = 0; success && (i < 9); i++)
+  {
+    byte moving = profile.movingThresholds.values[i];
+    byte stationary = profile.stationaryThresholds.values[i];
+    if (moving == 0xFF)
+      moving = movingThresholds.values[i];
+    else if (moving > 100)
+      moving = 100;
+    if (stationary == 0xFF)
+      stationary = stationaryThresholds.values[i];
+    else if (stationary > 100)
+      stationary = 100;
+    if ((moving == movingThresholds.values[i]) && (stationary == stationaryThresholds.values[i]))
+      continue;
+    byte cmd[0x16];
+    memcpy(cmd, LD2410::gateParam, 0x16);
+    cmd[6] = i;
+    cmd[7] = 0;
+    cmd[12] = moving;
+    cmd[18] = stationary;
+    success = sendCommand(cmd);
+    if (success)
+    {
+      movingThresholds.values[i] = moving;
+      stationaryThresholds.values[i] = stationary;
+      commands++;
+    }
+  }
+  byte maxMoving = (profile.maxMovingGate < 0) ? movingThresholds.N : (profile.maxMovingGate > 8) ? 8 : profile.maxMovingGate;
+  byte maxStationary = (profile.maxStationaryGate < 0) ? stationaryThresholds.N : (profile.maxStationaryGate > 8) ? 8 : profile.maxStationaryGate;
+  byte window = (profile.noOneWindow < 0) ? noOne_window : (profile.noOneWindow > 0xFF) ? 0xFF : profile.noOneWindow;
+  if (success &&
+      ((maxMoving != movingThresholds.N) ||
+       (maxStationary != stationaryThresholds.N) ||
+       (window != noOne_window)))
+  {
+    byte cmd[0x16];
+    memcpy(cmd, LD2410::maxGate, 0x16);
+    cmd[6] = maxMoving;
+    cmd[12] = maxStationary;
+    cmd[18] = window;
+    success = sendCommand(cmd);
+    if (success)
+    {
+      movingThresholds.setN(cmd[6]);
+      stationaryThresholds.setN(cmd[12]);
+      noOne_window = window;
+      maxRange = (cmd[6] > cmd[12]) ? cmd[6] : cmd[12];
+      commands++;
+    }
+  }
+  if (success && (profile.resolution >= 0) && (profile.resolution != fineRes))
+  {
+    success = sendCommand((profile.resolution) ? LD2410::resFine : LD2410::resCoarse);
+    if (success)
+    {
+      fineRes = (profile.resolution) ? 1 : 0;
+      commands++;
+    }
+  }
+#ifndef LD2410_NO_AUX
+  if (success && aux)
+  {
+    LightControl light = (profile.lightControl != LightControl::NOT_SET) ? profile.lightControl : lightControl;
+    byte threshold = (profile.lightControl != LightControl::NOT_SET) ? profile.lightThreshold : lightThreshold;
+    OutputControl output = (profile.outputControl != OutputControl::NOT_SET) ? profile.outputControl : outputControl;
+    if ((light != lightControl) || (threshold != lightThreshold) || (output != outputControl))
+    {
+      byte cmd[8];
+      memcpy(cmd, LD2410::auxConfig, 8);
+      cmd[4] = byte(light);
+      cmd[5] = threshold;
+      cmd[6] = byte(output);
+      success = sendCommand(cmd);
+      if (success)
+      {
+        lightControl = light;
+        lightThreshold = threshold;
+        outputControl = output;
+        commands++;
+      }
+    }
+  }
+#endif
+  // the Bluetooth state and the baud rate cannot be queried; they take effect after a reboot
+#ifndef LD2410_NO_BLUETOOTH
+  if (success && (profile.bluetooth >= 0))
+  {
+    success = sendCommand((profile.bluetooth) ? LD2410::BTon : LD2410::BToff);
+    if (success)
+    {
+      reboot = true;
+      commands++;
+    }
+  }
+#endif
+  if (success && (profile.baud >= 1) && (profile.baud <= 8))
+  {
+    byte cmd[6];
+    memcpy(cmd, LD2410::changeBaud, 6);
+    cmd[4] = profile.baud;
+    success = sendCommand(cmd);
+    if (success)
+    {
+      reboot = true;
+      commands++;
+    }
+  }
+  if (sent)
+    *sent = commands;
+  if (reboot)
+    return requestReboot() && success;
+  if (!wasConfig)
+    return configMode(false) && success;
+  return success;
+}
+#endif
 
 byte MyLD2410::getResolution()
 {
@@ -792,9 +1551,10 @@ byte MyLD2410::getResolution()
 
 byte MyLD2410::getLightLevel()
 {
-  return lightLevel;
+  return sData.lightLevel;
 }
 
+#ifndef LD2410_NO_AUX
 LightControl MyLD2410::getLightControl()
 {
   if (lightControl == LightControl::NOT_SET)
@@ -837,8 +1597,9 @@ bool MyLD2410::resetAuxControl()
     return sendCommand(LD2410::auxConfig) && requestAuxConfig();
   return configMode() && sendCommand(LD2410::auxConfig) && requestAuxConfig() && configMode(false);
 }
+#endif
 
 byte MyLD2410::getOutLevel()
 {
-  return outLevel;
+  return sData.outLevel;
 }
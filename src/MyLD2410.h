@@ -14,10 +14,14 @@ https://github.com/iavorvel/MyLD2410
  */
 
 #include <Arduino.h>
+#include "MyLD2410Config.h"
+#include "LD2410Parser.h"
+#ifndef LD2410_NO_TRACE
+#include "LD2410Trace.h"
+#endif
 #ifndef LD2410_BAUD_RATE
 #define LD2410_BAUD_RATE 256000
 #endif
-#define LD2410_BUFFER_SIZE 0x40
 #define LD2410_LATEST_FIRMWARE "2.44"
 
 /**
@@ -52,6 +56,25 @@ enum class AutoStatus
   COMPLETED
 };
 
+/**
+ * @brief How the driver reads from a serial type. The default calls the methods of SerialT
+ * directly (non-virtually), so that they can be inlined into the parser loop;
+ * for Stream itself the calls stay virtual.
+ */
+template <class SerialT>
+struct LD2410Port
+{
+  static int available(SerialT &serial) { return serial.SerialT::available(); }
+  static int read(SerialT &serial) { return serial.SerialT::read(); }
+};
+
+template <>
+struct LD2410Port<Stream>
+{
+  static int available(Stream &serial) { return serial.available(); }
+  static int read(Stream &serial) { return serial.read(); }
+};
+
 class MyLD2410
 {
 public:
@@ -61,45 +84,119 @@ public:
     ACK,
     DATA
   };
-  struct ValuesArray
+  typedef LD2410Parser::ValuesArray ValuesArray;
+  typedef LD2410Parser::SensorData SensorData;
+#ifndef LD2410_NO_STATISTICS
+  /**
+   * @brief Running minimum, average and maximum of a duration in [us]
+   */
+  struct TimeStats
   {
-    byte values[9];
-    byte N = 0;
+    unsigned long min = 0;
+    unsigned long max = 0;
+    unsigned long long total = 0;
+    unsigned long count = 0;
 
-    void setN(byte n)
+    void add(unsigned long value)
     {
-      N = (n <= 8) ? n : 8;
+      if (!count || value < min)
+        min = value;
+      if (value > max)
+        max = value;
+      total += value;
+      count++;
     }
-    ValuesArray &operator=(const ValuesArray &other)
+    unsigned long average() const
     {
-      if (this != &other)
-      {
-        N = other.N;
-        for (byte i = 0; i <= N; i++)
-          values[i] = other.values[i];
-      }
-      return *this;
+      return (count) ? (unsigned long)(total / count) : 0;
     }
-    template <typename ByteHandler>
-    void forEach(ByteHandler func) const
+  };
+  /**
+   * @brief Link and parser counters.
+   * Compile with -DLD2410_NO_STATISTICS to remove them altogether.
+   */
+  struct Statistics
+  {
+    unsigned long bytesRead = 0;       // all bytes taken from the stream
+    unsigned long bytesDiscarded = 0;  // bytes skipped while searching for a frame header
+    unsigned long dataFrames = 0;      // valid data frames
+    unsigned long ackFrames = 0;       // valid command replies
+    unsigned long tailErrors = 0;      // frames with a wrong tail
+    unsigned long lengthErrors = 0;    // frames with a zero or too large length field
+    unsigned long malformedFrames = 0; // data frames with an unknown type/marker
+    unsigned long timeouts = 0;        // frames that did not complete in time
+    unsigned long ackErrors = 0;       // command replies with a non-zero status
+    TimeStats checkTime;               // time spent in check() calls that consumed bytes
+    TimeStats parseTime;               // time spent decoding a received frame
+    TimeStats frameInterval;           // time between the arrival of consecutive data frames
+    TimeStats frameLatency;            // time from the first header byte to the decoded frame
+  };
+#endif
+  /**
+   * @brief A hole in the data stream caused by a config session, during which the sensor sends no data frames
+   */
+  struct ConfigGap
+  {
+    unsigned long start = 0;  // timestamp [ms] of the last data frame before config mode
+    unsigned long end = 0;    // timestamp [ms] of the first data frame after config mode
+    unsigned long frames = 0; // the number of data frames the sensor did not send
+  };
+#ifndef LD2410_NO_PROFILE
+  /**
+   * @brief All writable sensor parameters, to be applied at once with applyProfile().
+   * A default-constructed profile leaves everything unchanged; readProfile() fills in all readable parameters.
+   * Parameters of features that are compiled out are ignored.
+   */
+  struct DeviceProfile
+  {
+    ValuesArray movingThresholds;                         // thresholds of all 9 gates [0 - 100], 0xFF = leave unchanged (N is not used)
+    ValuesArray stationaryThresholds;                     // thresholds of all 9 gates [0 - 100], 0xFF = leave unchanged (N is not used)
+    int maxMovingGate = -1;                               // [1 - 8], -1 = leave unchanged
+    int maxStationaryGate = -1;                           // [1 - 8], -1 = leave unchanged
+    int noOneWindow = -1;                                 // [s], -1 = leave unchanged
+    int resolution = -1;                                  // 1 = fine (20cm), 0 = coarse (75cm), -1 = leave unchanged
+    LightControl lightControl = LightControl::NOT_SET;    // NOT_SET = leave unchanged
+    byte lightThreshold = 0x80;                           // used with lightControl
+    OutputControl outputControl = OutputControl::NOT_SET; // NOT_SET = leave unchanged
+    byte baud = 0;                                        // baud rate index [1 - 8], 0 = leave unchanged
+    int bluetooth = -1;                                   // 1 = on, 0 = off, -1 = leave unchanged
+
+    DeviceProfile()
     {
-      for (byte i = 0; i <= N; i++)
-        func(values[i]);
+      for (byte i = 0; i < 9; i++)
+      {
+        movingThresholds.values[i] = 0xFF;
+        stationaryThresholds.values[i] = 0xFF;
+      }
     }
   };
-  struct SensorData
+#endif
+  typedef void (*DataCallback)(const SensorData &data, void *context);
+#ifndef LD2410_NO_EARLY_DISPATCH
+  enum EarlyPhase
   {
-    byte status;
-    unsigned long timestamp;
-    unsigned long mTargetDistance;
-    byte mTargetSignal;
-    unsigned long sTargetDistance;
-    byte sTargetSignal;
-    unsigned long distance;
-    // Enhanced data
-    ValuesArray mTargetSignals;
-    ValuesArray sTargetSignals;
+    EARLY = 0, // the status and distance fields have arrived; the rest of the frame has not
+    COMMIT,    // the frame was received completely and is valid: the data is final
+    ROLLBACK   // the frame turned out to be invalid or incomplete: disregard the early data
   };
+  typedef void (*EarlyCallback)(EarlyPhase phase, const SensorData &data, void *context);
+#endif
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  typedef void (*AutoThresholdsCallback)(AutoStatus status, unsigned long elapsed, void *context);
+#endif
+#ifndef LD2410_NO_ADAPTIVE
+  /**
+   * @brief The estimated savings of the adaptive (basic/enhanced) mode policy
+   */
+  struct AdaptiveSavings
+  {
+    unsigned long basicFrames = 0;    // data frames received in basic mode while the policy was active
+    unsigned long enhancedFrames = 0; // data frames received in enhanced mode while the policy was active
+    unsigned long switches = 0;       // successful mode switches performed by the policy
+    unsigned long bytesSaved = 0;     // UART bytes that enhanced frames would have added
+    unsigned long microsSaved = 0;    // decoding time [us] that enhanced frames would have added
+  };
+#endif
 
 private:
   SensorData sData;
@@ -107,34 +204,118 @@ private:
   ValuesArray movingThresholds;
   byte maxRange = 0;
   byte noOne_window = 0;
-  byte lightLevel = 0;
-  byte outLevel = 0;
+#ifndef LD2410_NO_AUX
   byte lightThreshold = 0;
   LightControl lightControl = LightControl::NOT_SET;
   OutputControl outputControl = OutputControl::NOT_SET;
+#endif
+#ifndef LD2410_NO_AUTO_THRESHOLDS
   AutoStatus autoStatus = AutoStatus::NOT_SET;
+#endif
   unsigned long version = 0;
   unsigned long bufferSize = 0;
   unsigned long dataFrames = 0;
+  unsigned long frameStartMicros = 0;
+  unsigned long byteMicros = 10000000UL / LD2410_BAUD_RATE;
+  unsigned long framePeriod = 0; // recovered sensor frame period [us]
+  unsigned long frameJitter = 0; // mean deviation from the recovered period [us]
+  unsigned long suppressedFrames = 0;
+  ConfigGap lastGap;
+  bool inGap = false;
+  unsigned long lastReply = 0;
+  unsigned long pendingFrames = 0;
+  unsigned long skippedFrames = 0;
+  bool coalesce = false;
+  DataCallback dataCallback = nullptr;
+  void *dataContext = nullptr;
+#ifndef LD2410_NO_EARLY_DISPATCH
+  EarlyCallback earlyCallback = nullptr;
+  void *earlyContext = nullptr;
+  bool earlyPending = false;
+  SensorData earlyData;
+  void earlyDispatch(LD2410Parser::Event event);
+  void earlyFinish(EarlyPhase phase);
+#endif
+#ifndef LD2410_NO_TRACE
+  LD2410Trace *trace = nullptr;
+  unsigned long configStartUs = 0;
+  void traceConfig();
+#endif
+#ifndef LD2410_NO_BLUETOOTH
   byte MAC[6];
-  String MACstr = "";
-  String firmware = "";
+  bool hasMAC = false;
+#endif
   byte firmwareMajor = 0;
   byte firmwareMinor = 0;
+  byte firmwareBuild[4];
   int fineRes = -1;
   bool isEnhanced = false;
   bool isConfig = false;
-  byte inBuf[LD2410_BUFFER_SIZE];
-  byte inBufI = 0;
-  byte headBuf[4];
-  byte headBufI = 0;
+  LD2410Parser parser;
+  unsigned long frameStart = 0;
+#ifndef LD2410_NO_STATISTICS
+  Statistics stats;
+#endif
+#ifndef LD2410_NO_ADAPTIVE
+  bool adaptive = false;
+  byte gateSubscribers = 0;
+  unsigned long basicHold = 0;
+  unsigned long lastPresence = 0;
+  unsigned long lastSwitch = 0;
+  unsigned long basicDecode8 = 0;    // decoding time [us] x 8, moving average
+  unsigned long enhancedDecode8 = 0; // decoding time [us] x 8, moving average
+  byte enhancedFrameSize = 45;
+  AdaptiveSavings savings;
+  void adaptiveAccount(unsigned long decodeTime);
+  void adaptiveUpdate();
+#endif
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+  enum CalibrationStep
+  {
+    CAL_IDLE,
+    CAL_CONFIG,
+    CAL_START,
+    CAL_WAIT,
+    CAL_QUERY,
+    CAL_PARAM,
+    CAL_EXIT
+  };
+  byte calStep = CAL_IDLE;
+  byte calCommand[6];
+  AutoStatus calResult = AutoStatus::NOT_SET;
+  unsigned long calStart = 0;
+  unsigned long calSent = 0;
+  unsigned long calWait = 0;
+  bool calKeepConfig = false; // the sketch was in config mode when the job started
+  AutoThresholdsCallback calProgress = nullptr;
+  AutoThresholdsCallback calDone = nullptr;
+  void *calContext = nullptr;
+  void calibrationSend(byte step, const byte *command);
+  void calibrationStep();
+  void calibrationAck(unsigned long command, bool ok);
+  void calibrationExit();
+  void calibrationDone();
+#endif
   Stream *sensor;
   bool _debug = false;
   bool isDataValid();
-  bool readFrame();
+  LD2410Parser::Event receive(byte b, int buffered = -1);
+  void checkTimeout();
+  void writeCommand(const byte *command);
   bool sendCommand(const byte *command);
   bool processAck();
   bool processData();
+  void recoverClock(unsigned long interval);
+  void closeGap(unsigned long now);
+  unsigned long frameDuration();
+  unsigned long wakeGuard();
+
+protected:
+  bool beginCheck(Response &response, unsigned long &frames, bool jobs = true);
+  Response process(byte b, int buffered = -1);
+  Response finishCheck(Response response, unsigned long frames, bool jobs = true);
+  template <class SerialT>
+  Response drain(SerialT &serial);
 
 public:
   /**
@@ -157,6 +338,16 @@ public:
    */
   void end();
 
+  /**
+   * @brief Drop the bytes waiting in the serial buffer and the frame in progress, and wait for the next frame header
+   *
+   * @param exitConfig - also send the config-disable command, whether or not the library
+   * believes the sensor to be in config mode
+   * @return true on success. Without exitConfig, always true unless an auto-thresholds job
+   * is waiting for a reply; with exitConfig, false while any such job is running.
+   */
+  bool resync(bool exitConfig = false);
+
   /**
    * @brief Set the debug flag
    *
@@ -170,13 +361,110 @@ public:
   void debugOff();
 
   /**
-    @brief Call this function in the main loop
+    @brief Call this function in the main loop.
+    Data frames decoded while a command was waiting for its reply are reported by the next call.
     @return MyLD2410::DATA = (evaluates to true) if the latest frame contained data
     @return MyLD2410::ACK  = (evaluates to true) if the latest frame contained a reply to a command
     @return MyLD2410::FAIL = (evaluates to false) if no useful info was processed
     */
   Response check();
 
+  /**
+   * @brief Push a chunk of received bytes instead of letting check() read the sensor stream,
+   * e.g. from a UART receive event (see LD2410Esp32.h). Does the same work as check(),
+   * but always consumes the whole chunk. feed() never sends commands, so it can run on a driver task:
+   * the adaptive mode policy and a background autoThresholds() job only advance in check().
+   *
+   * @param data - the received bytes
+   * @param size - the number of bytes
+   * @return MyLD2410::Response - as check()
+   */
+  Response feed(const byte *data, size_t size);
+
+  /**
+   * @brief Let check() drain all available bytes instead of returning after the first frame.
+   * Every frame is still decoded (counters and callbacks stay correct), but only the newest state
+   * is reported; check() returns DATA if any data frame was decoded.
+   *
+   * @param enable [true]/false
+   */
+  void coalesceFrames(bool enable = true);
+
+  /**
+   * @brief Get the number of data frames that the latest check() decoded, but superseded by a newer one
+   *
+   * @return unsigned long
+   */
+  unsigned long getSkippedFrames();
+
+#ifndef LD2410_NO_ADAPTIVE
+  /**
+   * @brief Let the library switch between basic and enhanced mode on its own:
+   * enhanced mode while presence is detected, or while gate data is subscribed to;
+   * basic mode once the room has been empty for basicHold [ms].
+   * Mode switches are at least 2s apart, to avoid flapping. After a failed switch
+   * the library leaves config mode (see resync()), so that the data stream resumes.
+   *
+   * @param enable [true]/false
+   * @param basic_hold - time [ms] without presence before returning to basic mode
+   */
+  void adaptiveMode(bool enable = true, unsigned long basic_hold = 10000);
+
+  /**
+   * @brief Check whether the adaptive mode policy is active
+   */
+  bool inAdaptiveMode();
+
+  /**
+   * @brief Register (or release) a consumer of the per-gate signals.
+   * While at least one consumer is registered, the adaptive policy keeps the sensor in enhanced mode.
+   *
+   * @param subscribe [true]/false
+   */
+  void subscribeGateData(bool subscribe = true);
+
+  /**
+   * @brief Get the estimated savings of the adaptive mode policy
+   *
+   * @return AdaptiveSavings
+   */
+  AdaptiveSavings getAdaptiveSavings();
+#endif
+
+  /**
+   * @brief Register a function to be called with every decoded data frame,
+   * including the frames that arrive while a command waits for its reply
+   *
+   * @param callback - void callback(const MyLD2410::SensorData &data, void *context); nullptr to unregister
+   * @param context - an arbitrary pointer passed back to the callback
+   */
+  void onData(DataCallback callback, void *context = nullptr);
+
+#ifndef LD2410_NO_EARLY_DISPATCH
+  /**
+   * @brief Register a function to be called as soon as the status and distance fields
+   * of a data frame have arrived, before the rest of the frame (about 1.5ms earlier in enhanced mode).
+   * The early data holds status, the target distances and energies, distance and the timestamps;
+   * the gate energies are empty. Every EARLY call is followed by exactly one COMMIT (with the
+   * complete data, before the onData callback) or ROLLBACK (the frame was invalid or incomplete).
+   *
+   * @param callback - void callback(MyLD2410::EarlyPhase phase, const MyLD2410::SensorData &data, void *context);
+   * nullptr to unregister
+   * @param context - an arbitrary pointer passed back to the callback
+   */
+  void onEarlyData(EarlyCallback callback, void *context = nullptr);
+#endif
+
+#ifndef LD2410_NO_TRACE
+  /**
+   * @brief Record a timeline span for every command (with its reply latency), every config session,
+   * every data frame and every fixed pause of the bulk setters
+   *
+   * @param trace - e.g. an LD2410TraceBuffer<128>; nullptr to stop tracing
+   */
+  void setTrace(LD2410Trace *trace);
+#endif
+
   // GETTERS
 
   /**
@@ -231,6 +519,64 @@ public:
    */
   unsigned long getTimestamp();
 
+  /**
+   * @brief Get the time (in microseconds) when the first header byte of the last data frame arrived.
+   * Bytes still waiting in the serial buffer are accounted for, using the baud rate.
+   */
+  unsigned long getTimestampMicros();
+
+  /**
+   * @brief Get the age of the last data frame: the time [us] elapsed since its first header byte arrived
+   */
+  unsigned long getFrameAge();
+
+  /**
+   * @brief Get the sensor frame period [us], as recovered from the frame arrival times
+   *
+   * @return unsigned long - 0 until the first estimate is available
+   */
+  unsigned long getFramePeriod();
+
+  /**
+   * @brief Get the jitter of the frame arrival times [us]: the mean deviation from the recovered period
+   */
+  unsigned long getFrameJitter();
+
+  /**
+   * @brief Predict when the first header byte of the next data frame will arrive.
+   * A frame that is overdue by more than its own duration is assumed lost, and the one after it is predicted.
+   *
+   * @return unsigned long - the micros() time of the predicted arrival; 0 until the frame period is known
+   */
+  unsigned long nextFrameExpectedAt();
+
+  /**
+   * @brief Get the time [us] the sketch may spend elsewhere (or asleep) before calling check(),
+   * without delaying the next data frame: until shortly before the predicted frame is complete.
+   * The serial port keeps receiving in the meantime.
+   *
+   * @return unsigned long - 0 if check() should be called now (bytes waiting, frame in progress,
+   * config mode, or the period is not yet known)
+   */
+  unsigned long idleHint();
+
+  /**
+   * @brief Sleep with delay() until shortly before the next data frame is complete (see idleHint()).
+   * On ESP32, delay() blocks the task, so the CPU idles or enters automatic light sleep.
+   *
+   * @param maxWait - the longest wait [us]
+   * @return true if it waited; false if check() should be called now
+   */
+  bool waitForNextFrame(unsigned long maxWait = 1000000UL);
+
+  /**
+   * @brief Tell the library the baud rate of the sensor serial,
+   * if it differs from LD2410_BAUD_RATE (used to correct the frame arrival times)
+   *
+   * @param baud
+   */
+  void setBaudRate(unsigned long baud);
+
   /**
    * @brief Get the number of data frames received so far
    *
@@ -238,6 +584,41 @@ public:
    */
   unsigned long getFrameCount();
 
+  /**
+   * @brief Get the number of data frames the sensor did not send while in config mode
+   *
+   * @return unsigned long
+   */
+  unsigned long getSuppressedFrames();
+
+  /**
+   * @brief Get the most recent hole in the data stream caused by config mode
+   *
+   * @return const ConfigGap&
+   */
+  const ConfigGap &getLastConfigGap();
+
+  /**
+   * @brief Get the arrival time of the latest command reply
+   *
+   * @return unsigned long - timestamp [ms]
+   */
+  unsigned long getLastReplyTime();
+
+#ifndef LD2410_NO_STATISTICS
+  /**
+   * @brief Get a snapshot of the link and parser statistics
+   *
+   * @return Statistics - a copy of the counters at the time of the call
+   */
+  Statistics getStatistics();
+
+  /**
+   * @brief Reset all link and parser statistics to zero
+   */
+  void resetStatistics();
+#endif
+
   /**
    * @brief Check whether presence was detected in the latest frame
    */
@@ -302,6 +683,7 @@ public:
    */
   unsigned long detectedDistance();
 
+#ifndef LD2410_NO_BLUETOOTH
   /**
    * @brief Get the Bluetooth MAC address as an array byte[6]
    *
@@ -315,6 +697,7 @@ public:
    * @return String
    */
   String getMACstr();
+#endif
 
   /**
    * @brief Get the Firmware as a String
@@ -337,6 +720,13 @@ public:
    */
   byte getFirmwareMinor();
 
+  /**
+   *  @brief Get the Firmware build number: its hexadecimal digits are the last part of getFirmware()
+   *
+   *  @return unsigned long
+   */
+  unsigned long getFirmwareBuild();
+
   /**
    * @brief Get the protocol version
    *
@@ -416,13 +806,16 @@ public:
    */
   bool enhancedMode(bool enable = true);
 
+#ifndef LD2410_NO_AUX
   /**
    * @brief Request the current auxiliary configuration
    *
    * @return true on success
    */
   bool requestAuxConfig();
+#endif
 
+#ifndef LD2410_NO_AUTO_THRESHOLDS
   /**
    * @brief Begin the automatic threshold detection routine
    * (firmware >= 2.44)
@@ -440,12 +833,36 @@ public:
    */
   AutoStatus getAutoStatus();
 
+  /**
+   * @brief Run the automatic threshold detection routine in the background
+   * (firmware >= 2.44).
+   * The job is advanced by check(): it stays in a single config session, polls the status
+   * once per second after the timeout, and reads back the new thresholds on completion.
+   * Other commands are refused (return false) while the job is running.
+   * If the sensor is already in config mode, the job leaves it in config mode at the end.
+   *
+   * @param _timeout - allow for timeout [s] to leave the room
+   * @param progress - called after each poll that reports IN_PROGRESS
+   * @param done - called at the end with COMPLETED, NOT_IN_PROGRESS (stopped by the sensor) or NOT_SET (communication failure)
+   * @param context - an arbitrary pointer passed back to the callbacks
+   * @return true if the job was started
+   */
+  bool startAutoThresholds(byte _timeout = 10, AutoThresholdsCallback progress = nullptr, AutoThresholdsCallback done = nullptr, void *context = nullptr);
+
+  /**
+   * @brief Check whether a background auto-thresholds job is running
+   */
+  bool autoThresholdsRunning();
+#endif
+
+#ifndef LD2410_NO_BLUETOOTH
   /**
    * @brief Request the Bluetooth MAC address
    *
    * @return true on success
    */
   bool requestMAC();
+#endif
 
   /**
    * @brief Request the Firmware
@@ -461,6 +878,7 @@ public:
    */
   bool requestResolution();
 
+#ifndef LD2410_NO_SETTERS
   /**
    * @brief Set the resolution of the sensor
    *
@@ -468,6 +886,7 @@ public:
    * @return true on success
    */
   bool setResolution(bool fine = false);
+#endif
 
   /**
    * @brief Request the sensor parameters:
@@ -477,6 +896,7 @@ public:
    */
   bool requestParameters();
 
+#ifndef LD2410_NO_SETTERS
   /**
    * @brief Set the gate parameters for a particular gate, or for all gates at once
    *
@@ -550,6 +970,7 @@ public:
    * @return true on success
    */
   bool setMaxStationaryGate(byte stationaryGate);
+#endif
 
   /**
    * @brief Get the maximum moving gate
@@ -565,12 +986,14 @@ public:
    */
   byte getMaxStationaryGate();
 
+#ifndef LD2410_NO_SETTERS
   /**
    * @brief Request reset to factory default parameters
    *
    * @return true on success
    */
   bool requestReset();
+#endif
 
   /**
    * @brief Request reboot
@@ -579,6 +1002,7 @@ public:
    */
   bool requestReboot();
 
+#ifndef LD2410_NO_BLUETOOTH
   /**
    * @brief Turn Bluetooth ON
    *
@@ -619,13 +1043,38 @@ public:
    * @return true on success
    */
   bool resetBTpassword();
+#endif
 
+#ifndef LD2410_NO_BAUD
   /**
    * @brief Reset the serial baud rate. The sensor reboots at the new rate on success
    *
    * @return true on success
    */
   bool setBaud(byte baud);
+#endif
+
+#ifndef LD2410_NO_PROFILE
+  /**
+   * @brief Read all readable parameters into a profile
+   * (the baud rate and the Bluetooth state cannot be queried and are left unchanged)
+   *
+   * @param profile
+   * @return true on success
+   */
+  bool readProfile(DeviceProfile &profile);
+
+  /**
+   * @brief Bring the sensor to the given profile in a single config session.
+   * The current state is read once, and only the parameters that differ are sent.
+   * If the Bluetooth state or the baud rate is set, the sensor reboots at the end.
+   *
+   * @param profile
+   * @param sent - optionally receives the number of write commands sent
+   * @return true on success
+   */
+  bool applyProfile(const DeviceProfile &profile, byte *sent = nullptr);
+#endif
 
   /**
    * @brief Get the Light Level
@@ -634,6 +1083,7 @@ public:
    */
   byte getLightLevel();
 
+#ifndef LD2410_NO_AUX
   /**
    * @brief Get the Light Control parameter
    *
@@ -672,6 +1122,7 @@ public:
    * @return OutputControl enum
    */
   OutputControl getOutputControl();
+#endif
 
   /**
    * @brief Get the Light Level
@@ -681,4 +1132,64 @@ public:
   byte getOutLevel();
 };
 
+template <class SerialT>
+MyLD2410::Response MyLD2410::drain(SerialT &serial)
+{
+  Response response = FAIL;
+  unsigned long frames = 0;
+  if (beginCheck(response, frames))
+    return response;
+  if (!LD2410Port<SerialT>::available(serial))
+    return finishCheck(response, frames);
+#ifndef LD2410_NO_STATISTICS
+  unsigned long t0 = micros();
+#endif
+  while (LD2410Port<SerialT>::available(serial))
+  {
+    Response r = process(byte(LD2410Port<SerialT>::read(serial)));
+    if (r == DATA)
+      frames++;
+    if (r > response)
+      response = r;
+    if (r && !coalesce)
+      break;
+  }
+#ifndef LD2410_NO_STATISTICS
+  stats.checkTime.add(micros() - t0);
+#endif
+  return finishCheck(response, frames);
+}
+
+/**
+ * @brief A MyLD2410 bound to a concrete serial type (e.g. HardwareSerial, or a custom ring buffer
+ * derived from Stream). check() reads through SerialT directly, without virtual calls,
+ * so the compiler can inline the accessors into the parser loop.
+ * MyLD2410 itself is the Stream-based equivalent.
+ *
+ * @tparam SerialT - a class derived from Stream
+ */
+template <class SerialT>
+class MyLD2410T : public MyLD2410
+{
+public:
+  /**
+   * @brief Construct a new MyLD2410T object
+   *
+   * @param serial - a reference to the serial object (sensorSerial)
+   * @param debug - a flag that controls whether debug data will be sent to Serial
+   */
+  MyLD2410T(SerialT &serial, bool debug = false) : MyLD2410(serial, debug), port(serial) {}
+
+  /**
+   * @brief Call this function in the main loop (see MyLD2410::check())
+   */
+  Response check()
+  {
+    return drain(port);
+  }
+
+private:
+  SerialT &port;
+};
+
 #endif // MY_LD2410_H
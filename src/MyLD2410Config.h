@@ -0,0 +1,77 @@
+#ifndef MY_LD2410_CONFIG_H
+#define MY_LD2410_CONFIG_H
+
+/*
+
+MyLD2410 library
+An Arduino library for the LD2410 presence sensor, including HLK-LD2410B and HLK-LD2410C.
+https://github.com/iavorvel/MyLD2410
+
+*/
+
+/**
+ * @file MyLD2410Config.h
+ *
+ * Compile-time feature selection.
+ *
+ * The library is compiled separately from the sketch, so a #define placed in the sketch
+ * does NOT reach it. Either uncomment the lines below, or pass the flags to the whole build
+ * (e.g. PlatformIO: build_flags = -DLD2410_MINIMAL).
+ */
+
+// Strip everything that a sketch reading presence data does not need
+// #define LD2410_MINIMAL
+
+// Fine-grained switches
+// #define LD2410_NO_STATISTICS      // link and parser counters
+// #define LD2410_NO_DEBUG           // printing of received frames to Serial
+// #define LD2410_NO_ADAPTIVE        // automatic basic/enhanced mode switching
+// #define LD2410_NO_AUTO_THRESHOLDS // automatic thresholds (foreground and background)
+// #define LD2410_NO_PROFILE         // readProfile() and applyProfile()
+// #define LD2410_NO_BLUETOOTH       // MAC address, Bluetooth on/off and password
+// #define LD2410_NO_AUX             // auxiliary light/output control
+// #define LD2410_NO_BAUD            // setBaud()
+// #define LD2410_NO_SETTERS         // resolution, thresholds, gates, no-one window, factory reset
+// #define LD2410_NO_EARLY_DISPATCH  // onEarlyData()
+// #define LD2410_NO_TRACE           // setTrace() timeline spans
+
+#ifdef LD2410_MINIMAL
+#ifndef LD2410_NO_STATISTICS
+#define LD2410_NO_STATISTICS
+#endif
+#ifndef LD2410_NO_DEBUG
+#define LD2410_NO_DEBUG
+#endif
+#ifndef LD2410_NO_ADAPTIVE
+#define LD2410_NO_ADAPTIVE
+#endif
+#ifndef LD2410_NO_AUTO_THRESHOLDS
+#define LD2410_NO_AUTO_THRESHOLDS
+#endif
+#ifndef LD2410_NO_PROFILE
+#define LD2410_NO_PROFILE
+#endif
+#ifndef LD2410_NO_BLUETOOTH
+#define LD2410_NO_BLUETOOTH
+#endif
+#ifndef LD2410_NO_AUX
+#define LD2410_NO_AUX
+#endif
+#ifndef LD2410_NO_BAUD
+#define LD2410_NO_BAUD
+#endif
+#ifndef LD2410_NO_SETTERS
+#define LD2410_NO_SETTERS
+#endif
+#ifndef LD2410_NO_EARLY_DISPATCH
+#define LD2410_NO_EARLY_DISPATCH
+#endif
+#ifndef LD2410_NO_TRACE
+#define LD2410_NO_TRACE
+#endif
+#ifndef LD2410_BUFFER_SIZE
+#define LD2410_BUFFER_SIZE 0x28 // the largest frame (enhanced data) is 39 bytes
+#endif
+#endif
+
+#endif // MY_LD2410_CONFIG_H